@@ -7,6 +7,9 @@
 
 #include <math.h>
 #include "control-pid_sca.h"
+#include "control-pid-planificador_sca.h"
+#include "control-pid-telemetria_sca.h"
+#include "control-pid-planta_sca.h"
 
 #define TIEMPO_MUESTREO    500
 #define MODELO_RESISTENCIA 1
@@ -18,14 +21,24 @@
 #define SALIDA_MIN         0
 #define SALIDA_MAX         20
 #define COMPENSAR_INTEGRAL_AFIRMATIVO true
+#define TELEMETRIA_BINARIA 0   // 1: tramas binarias (decodificar con host/decodificar_telemetria)
+#define SIMULACION_ACELERADA 0 // 1: reloj virtual que salta al próximo período, sin esperar
+#if SIMULACION_ACELERADA
+#define MOSTRAR_CADA       1000 // Muestras por línea mostrada (el puerto serie es el límite)
+#else
+#define MOSTRAR_CADA       1
+#endif
 
 controlPID    Carga (PID_SIN_SALIDA);
+planificadorPID Planificador;
+telemetriaPID Telemetria;
+plantaPrimerOrden Modelo (MODELO_RESISTENCIA, MODELO_RESISTENCIA * MODELO_CAPACIDAD, 0);
 pid_config_s  ConfiguracionPID = {0};
 pid_info_s    InformePID       = {0};
 float         VoltajeSimulado  = 0;
 float         AccionControl    = 0;
 unsigned long TiempoInicial    = 0;
-unsigned long TiempoAnterior   = 0;
+unsigned long TiempoSimulado   = 0;    // Reloj virtual en microsegundos (SIMULACION_ACELERADA)
 
 //*****************************************************************************
 
@@ -40,13 +53,20 @@ void setup() {
   ConfiguracionPID.LimiteInferior    = SALIDA_MIN; 
   ConfiguracionPID.CompensarIntegral = COMPENSAR_INTEGRAL_AFIRMATIVO;
   Carga.Configurar( &ConfiguracionPID );
+  Carga.PeriodoFijo( TIEMPO_MUESTREO * 1000UL );  // El planificador lo llama a período fijo
+  Carga.Reloj( reloj );                           // Sin período fijo mediría con reloj()
   
   // Presentación inicial de información
   Serial.begin(9600);
+  TiempoSimulado = micros();
+  TiempoInicial  = reloj();
+#if !TELEMETRIA_BINARIA
   Serial.println( "Tiempo \tObj \tMed \tCtrl \tProp \tInt \tComp");
-  TiempoInicial = millis();
-  TiempoAnterior = TiempoInicial;
   mostrar();
+#endif
+
+  // El planificador llama a medir(), Controlar() y actuar() cada TIEMPO_MUESTREO
+  Planificador.Agregar( &Carga, medir, actuar, TIEMPO_MUESTREO * 1000UL, 0 );
 
 }
 
@@ -54,36 +74,74 @@ void setup() {
 
 void loop() {
 
-  do {
-    
-    // Acá se pueden poner otras acciones
-    
-  } while (millis() < (TiempoAnterior + TIEMPO_MUESTREO));
-  TiempoAnterior = TiempoAnterior + TIEMPO_MUESTREO;
+#if SIMULACION_ACELERADA
+  // Ejecuta el lazo vencido y adelanta el reloj virtual hasta el próximo: la simulación corre
+  // tan rápido como el procesador (y el puerto serie) lo permitan.
+  TiempoSimulado += Planificador.Ejecutar( TiempoSimulado );
+#else
+  // Ejecuta el lazo si venció su período; si no, vuelve enseguida.
+  Planificador.Ejecutar();
+#endif
+  
+#if TELEMETRIA_BINARIA
+  // Envía la telemetría pendiente sin esperar al puerto serie.
+  Telemetria.Transmitir( Serial );
+#endif
+
+  // Acá se pueden poner otras acciones
 
-  // Pasado el intervalo TIEMPO_MUESTREO: mido, calculo control y actúo.
+}
+
+//*****************************************************************************
 
+float medir()
+{
   // 1) LEEMOS MODELO ---------------------------------------------------------
-  VoltajeSimulado = sistemaSimulado( AccionControl ); 
-  
-  // 2) CALCULO ACCION DE CONTROL ---------------------------------------------
-  AccionControl = Carga.Controlar( VoltajeSimulado ); 
- 
+  // 2) Con lo que devuelve, el planificador calcula la acción de control
+  VoltajeSimulado = Modelo.Salida();
+  return VoltajeSimulado;
+}
+
+//*****************************************************************************
+
+void actuar(float SALIDA)
+{
   // 3) ACTUAR ----------------------------------------------------------------
-  VoltajeSimulado = sistemaSimulado( AccionControl ); 
-  // esto en realidad no hace nada porque es un sistema simulado
+  AccionControl = SALIDA;
+  // El sistema simulado avanza un período con esta acción; medir() lee el resultado
+  sistemaSimulado( AccionControl );
     
   // 4) MOSTRAR VALORES -------------------------------------------------------
   Carga.Leer( &InformePID );
-  mostrar();
+#if TELEMETRIA_BINARIA
+  Telemetria.Registrar( &InformePID, reloj() );
+#else
+  static unsigned int Muestras = 0;
+  if (++Muestras >= MOSTRAR_CADA) {
+    Muestras = 0;
+    mostrar();
+  }
+#endif
+}
 
+//*****************************************************************************
+
+unsigned long reloj()
+{
+  // Tiempo en microsegundos: el real o el virtual de la simulación acelerada.
+  // Las restas sin signo siguen siendo correctas cuando el contador desborda.
+#if SIMULACION_ACELERADA
+  return TiempoSimulado;
+#else
+  return micros();
+#endif
 }
 
 //*****************************************************************************
 
 void mostrar()
 {
-  Serial.print(TiempoAnterior-TiempoInicial);
+  Serial.print((reloj()-TiempoInicial)/1000);
   Serial.print("\t");
   Serial.print(ConfiguracionPID.Objetivo);
   Serial.print("\t");
@@ -102,26 +160,10 @@ void mostrar()
 
 float sistemaSimulado (float Corriente)
 {
-  // Valores del modelo del sistema
-  const float Resistencia = MODELO_RESISTENCIA;
-  const float Capacidad   = MODELO_CAPACIDAD;
-  const float Tau         = Resistencia * Capacidad;
-
-  // Variables almacenadas (estáticas)
-  static float Voltaje = 0;
-  static unsigned long T_Anterior = millis();
-
-  // Variables locales dinñamicas
-  unsigned long T_Actual = millis();
-  unsigned long T_Delta = (T_Actual - T_Anterior) ;
-
-  // Cambio de variabes de estado
-  float VF = Corriente * Resistencia;
-  Voltaje = (Voltaje-VF) * exp(-1.0*T_Delta/1000/Tau) + VF;
-  T_Anterior = T_Actual;
-
-  // Devolvemos estado actual
-  return Voltaje;
+  // Se llama una vez por período, desde actuar(): la corriente se mantiene durante
+  // TIEMPO_MUESTREO (retención de orden cero), como la aplicaría un actuador real.
+  // Con el intervalo constante, el modelo R-C calcula exp() una sola vez.
+  return Modelo.Simular( Corriente, TIEMPO_MUESTREO * 1000UL );
 }
 
 //*****************************************************************************
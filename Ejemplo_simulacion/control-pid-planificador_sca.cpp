@@ -0,0 +1,125 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-planificador_sca.cpp
+* Versión:    3.0 
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-planificador_sca.h"
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+planificadorPID::planificadorPID()
+{
+   Cantidad    = 0;
+   UltimoAhora = 0;
+   ConOrigen   = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int8_t planificadorPID::Agregar(controlPID * PID, float (*MEDIR)(), void (*ACTUAR)(float),
+                                unsigned long PERIODO, unsigned long FASE)
+// No lee micros(): Ejecutar(AHORA) puede usar otro reloj (uno virtual, o el de un timer). Antes
+// del primer Ejecutar() el vencimiento guarda sólo la FASE y Ejecutar() le suma su AHORA.
+{
+   if (Cantidad >= PLANIFICADOR_MAX_LAZOS || PERIODO == 0) {
+      return PLANIFICADOR_LLENO;
+   }
+   pid_tarea_s * T = &Tareas[Cantidad];
+   T->PID         = PID;
+   T->Medir       = MEDIR;
+   T->Actuar      = ACTUAR;
+   T->Periodo     = PERIODO;
+   T->Vencimiento = (ConOrigen ? UltimoAhora : 0) + FASE;
+   T->Info        = {};
+   return Cantidad++;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned long planificadorPID::Ejecutar()
+{
+   return Ejecutar(micros());
+}
+
+unsigned long planificadorPID::Ejecutar(unsigned long AHORA)
+// Mientras haya lazos vencidos ejecuta el de vencimiento más antiguo. Las restas entre tiempos
+// se hacen sin signo y se interpretan con signo, así funciona aunque micros() desborde.
+{
+   if (!ConOrigen) {
+      for (uint8_t t=0; t<Cantidad; t++) {
+         Tareas[t].Vencimiento += AHORA;  // Fases de los lazos agregados antes de arrancar
+      }
+      ConOrigen = true;
+   }
+   UltimoAhora = AHORA;
+
+   int8_t i;
+   while ( (i = ProximaTarea(AHORA)) >= 0 ) {
+      pid_tarea_s * T = &Tareas[i];
+      long Falta = long(T->Vencimiento - AHORA);
+      if (Falta > 0) {
+         return Falta;                    // Nada vencido: tiempo libre hasta el próximo
+      }
+      
+      // Retraso de esta activación:
+      T->Info.RetrasoUltimo = AHORA - T->Vencimiento;
+      if (T->Info.RetrasoUltimo > T->Info.RetrasoMaximo) {
+         T->Info.RetrasoMaximo = T->Info.RetrasoUltimo;
+      }
+      
+      // Medir, controlar y actuar:
+      float Salida = T->PID->Controlar( T->Medir() );
+      if (T->Actuar) {
+         T->Actuar(Salida);
+      }
+      T->Info.Ejecuciones++;
+      
+      // Próxima activación. Si ya pasaron más períodos, se saltean y se cuentan.
+      T->Vencimiento += T->Periodo;
+      if (long(AHORA - T->Vencimiento) >= 0) {
+         unsigned long Perdidos = (AHORA - T->Vencimiento) / T->Periodo + 1;
+         T->Info.PeriodosPerdidos += Perdidos;
+         T->Vencimiento += Perdidos * T->Periodo;
+      }
+   }
+   return 0;                              // No hay lazos registrados
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void planificadorPID::Leer(uint8_t TAREA, pid_tarea_info_s * INFO)
+{
+   if (TAREA < Cantidad) {
+      *INFO = Tareas[TAREA].Info;
+   }
+}
+
+/**************************************************************************************************
+* Funciones privadas
+**************************************************************************************************/
+
+int8_t planificadorPID::ProximaTarea(unsigned long AHORA)
+// Busca el vencimiento más próximo (o más atrasado). Con pocos lazos, recorrer la lista es más
+// barato que mantener una cola ordenada.
+{
+   int8_t Proxima = -1;
+   long   Menor   = 0;
+   for (uint8_t i=0; i<Cantidad; i++) {
+      long Falta = long(Tareas[i].Vencimiento - AHORA);
+      if (Proxima < 0 || Falta < Menor) {
+         Proxima = i;
+         Menor   = Falta;
+      }
+   }
+   return Proxima;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO control-pid-planificador_sca.cpp
+**************************************************************************************************/
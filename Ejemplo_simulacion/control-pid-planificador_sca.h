@@ -0,0 +1,73 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-planificador_sca.h
+* Breve:      Planificador no bloqueante de varios controlPID, cada uno con su período y fase.
+*             Reemplaza la espera activa do { } while (millis() < ...) del ejemplo: loop() llama
+*             a Ejecutar(), que corre los lazos vencidos (el de vencimiento más próximo primero)
+*             y devuelve cuánto falta para el siguiente, tiempo libre para otras tareas o para
+*             dormir. Registra por lazo las ejecuciones, los períodos perdidos y el retraso.
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_PLANIFICADOR_SCA_H
+#define CONTROL_PID_PLANIFICADOR_SCA_H
+
+#include "control-pid_sca.h"
+
+#ifndef PLANIFICADOR_MAX_LAZOS
+#define PLANIFICADOR_MAX_LAZOS 4          // Capacidad (se puede definir antes de incluir)
+#endif
+
+#define PLANIFICADOR_LLENO -1             // Agregar() no tiene lugar para otro lazo
+
+struct pid_tarea_info_s {
+   unsigned long Ejecuciones;             // Veces que se ejecutó el lazo
+   unsigned long PeriodosPerdidos;        // Activaciones salteadas por atraso (desbordes)
+   unsigned long RetrasoUltimo;           // Retraso de la última ejecución, en microsegundos
+   unsigned long RetrasoMaximo;           // Mayor retraso observado, en microsegundos
+};
+
+struct pid_tarea_s {
+   controlPID *  PID;
+   float       (*Medir)();                // Devuelve la medición del lazo
+   void        (*Actuar)(float SALIDA);   // Recibe la salida (0 si alcanza con PinSalida)
+   unsigned long Periodo;                 // En microsegundos
+   unsigned long Vencimiento;             // Próxima activación (tiempo de micros)
+   pid_tarea_info_s Info;
+};
+
+class planificadorPID                     // Clase para ejecutar varios lazos a distinto ritmo
+{
+   private:
+   pid_tarea_s   Tareas[PLANIFICADOR_MAX_LAZOS];
+   unsigned long UltimoAhora;             // Tiempo del último Ejecutar()
+   uint8_t       Cantidad;
+   bool          ConOrigen;               // Ya hubo un Ejecutar(): UltimoAhora es válido
+   
+   int8_t ProximaTarea(unsigned long AHORA);   // La de vencimiento más próximo
+
+   public:
+   planificadorPID();
+   int8_t Agregar(controlPID * PID, float (*MEDIR)(), void (*ACTUAR)(float),
+                  unsigned long PERIODO, unsigned long FASE);
+                                          // Registra un lazo con PERIODO y FASE (retardo de 
+                                          // la primera activación) en microsegundos. Devuelve
+                                          // su número o PLANIFICADOR_LLENO. La FASE se cuenta
+                                          // desde el primer Ejecutar() o, si ya hubo alguno,
+                                          // desde el tiempo del último, en el reloj que se le
+                                          // pase (micros() o el de Ejecutar(AHORA)).
+   unsigned long Ejecutar();              // Ejecuta los lazos vencidos según micros() y 
+                                          // devuelve los microsegundos hasta el próximo.
+   unsigned long Ejecutar(unsigned long AHORA);
+                                          // Ídem con el tiempo dado (p. ej. desde un timer).
+   void Leer(uint8_t TAREA, pid_tarea_info_s * INFO);
+                                          // Estadísticas de un lazo.
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_PLANIFICADOR_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
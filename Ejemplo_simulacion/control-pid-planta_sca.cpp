@@ -0,0 +1,165 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-planta_sca.cpp
+* Versión:    3.0 
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-planta_sca.h"
+
+#define ORDEN_TAYLOR 12           // Términos de la serie de exp() luego de escalar la matriz
+
+/**************************************************************************************************
+* Primer orden
+**************************************************************************************************/
+
+plantaPrimerOrden::plantaPrimerOrden(float GANANCIA, float TAU, float INICIAL)
+{
+   Ganancia           = GANANCIA;
+   Tau                = TAU;
+   Estado             = INICIAL;
+   IntervaloCalculado = 0;
+   Decaer             = 1;
+}
+
+float plantaPrimerOrden::Simular(float ENTRADA, unsigned long INTERVALO)
+// Misma cuenta que sistemaSimulado(), pero exp() sólo se evalúa si cambia el intervalo.
+{
+   if (INTERVALO != IntervaloCalculado) {
+      Decaer = exp( -(INTERVALO / 1e6f) / Tau );
+      IntervaloCalculado = INTERVALO;
+   }
+   float Final = ENTRADA * Ganancia;
+   Estado = (Estado - Final) * Decaer + Final;
+   return Estado;
+}
+
+float plantaPrimerOrden::Salida()
+{
+   return Estado;
+}
+
+void plantaPrimerOrden::Reiniciar(float SALIDA)
+{
+   Estado = SALIDA;
+}
+
+/**************************************************************************************************
+* Primer orden con retardo
+**************************************************************************************************/
+
+plantaPrimerOrdenRetardo::plantaPrimerOrdenRetardo(float GANANCIA, float TAU, float RETARDO, 
+                                                   float INICIAL)
+   : Dinamica(GANANCIA, TAU, INICIAL)
+{
+   Ganancia           = GANANCIA;
+   Retardo            = RETARDO;
+   Indice             = 0;
+   Muestras           = 0;
+   IntervaloCalculado = 0;
+   Reiniciar(INICIAL);
+}
+
+float plantaPrimerOrdenRetardo::Simular(float ENTRADA, unsigned long INTERVALO)
+// La dinámica recibe la entrada de hace Muestras intervalos.
+{
+   if (INTERVALO != IntervaloCalculado) {
+      float Cantidad = (INTERVALO > 0) ? Retardo * 1e6f / INTERVALO + 0.5f : 0;
+      Muestras = (Cantidad < PLANTA_RETARDO_MAXIMO-1) ? uint8_t(Cantidad) : PLANTA_RETARDO_MAXIMO-1;
+      IntervaloCalculado = INTERVALO;
+   }
+   Entradas[Indice] = ENTRADA;
+   uint8_t Anterior = (Indice + PLANTA_RETARDO_MAXIMO - Muestras) % PLANTA_RETARDO_MAXIMO;
+   Indice = (Indice + 1) % PLANTA_RETARDO_MAXIMO;
+   return Dinamica.Simular(Entradas[Anterior], INTERVALO);
+}
+
+float plantaPrimerOrdenRetardo::Salida()
+{
+   return Dinamica.Salida();
+}
+
+void plantaPrimerOrdenRetardo::Reiniciar(float SALIDA)
+// Reposo: las entradas retenidas son las que mantienen esa salida.
+{
+   float Entrada = (Ganancia != 0) ? SALIDA / Ganancia : 0;
+   Dinamica.Reiniciar(SALIDA);
+   for (uint8_t i=0; i<PLANTA_RETARDO_MAXIMO; i++) Entradas[i] = Entrada;
+}
+
+/**************************************************************************************************
+* Espacio de estados
+**************************************************************************************************/
+
+static void MultiplicarMatrices(const float * P, const float * Q, uint8_t N, float * R)
+{
+   for (uint8_t i=0; i<N; i++) {
+      for (uint8_t j=0; j<N; j++) {
+         float S = 0;
+         for (uint8_t k=0; k<N; k++) S += P[i*N+k] * Q[k*N+j];
+         R[i*N+j] = S;
+      }
+   }
+}
+
+void ExponencialMatriz(const float * M, uint8_t N, float * RESULTADO, float * AUXILIAR)
+// Escalado y cuadrado: exp(M) = exp(M/2^s)^(2^s), con s tal que |M/2^s| <= 1/2, y la serie de
+// Taylor evaluada por Horner: I + X (I + X/2 (I + X/3 (...))).
+{
+   float * X        = AUXILIAR;
+   float * Producto = AUXILIAR + N*N;
+   float   Norma    = 0;
+   uint8_t s        = 0;
+   
+   for (uint8_t i=0; i<N; i++) {
+      float Fila = 0;
+      for (uint8_t j=0; j<N; j++) Fila += fabs(M[i*N+j]);
+      Norma = max(Norma, Fila);
+   }
+   float Escala = 1;
+   while (Norma * Escala > 0.5f && s < 60) {
+      Escala = Escala / 2;
+      s++;
+   }
+   for (uint8_t i=0; i<N*N; i++) {
+      X[i]         = M[i] * Escala;
+      RESULTADO[i] = (i % (N+1) == 0) ? 1 : 0;          // Identidad
+   }
+   for (uint8_t k=ORDEN_TAYLOR; k>=1; k--) {
+      MultiplicarMatrices(X, RESULTADO, N, Producto);
+      for (uint8_t i=0; i<N*N; i++) {
+         RESULTADO[i] = Producto[i] / k + ( (i % (N+1) == 0) ? 1 : 0 );
+      }
+   }
+   for (uint8_t c=0; c<s; c++) {
+      MultiplicarMatrices(RESULTADO, RESULTADO, N, Producto);
+      for (uint8_t i=0; i<N*N; i++) RESULTADO[i] = Producto[i];
+   }
+}
+
+/**************************************************************************************************
+* Segundo orden
+**************************************************************************************************/
+
+plantaSegundoOrden::plantaSegundoOrden(float GANANCIA, float WN, float ZETA, float INICIAL)
+// Realización con x1 = y, x2 = y'.
+{
+   const float MatrizA[4] = { 0, 1, -WN*WN, -2*ZETA*WN };
+   const float VectorB[2] = { 0, GANANCIA*WN*WN };
+   const float VectorC[2] = { 1, 0 };
+   Configurar(MatrizA, VectorB, VectorC, 0);
+   Reiniciar(INICIAL);
+}
+
+void plantaSegundoOrden::Reiniciar(float SALIDA)
+// En reposo y' = 0 para cualquier salida (con entrada SALIDA/GANANCIA).
+{
+   const float Reposo[2] = { SALIDA, 0 };
+   Estado(Reposo);
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO control-pid-planta_sca.cpp
+**************************************************************************************************/
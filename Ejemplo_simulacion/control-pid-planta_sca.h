@@ -0,0 +1,212 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-planta_sca.h
+* Breve:      Modelos de planta para simular un controlPID sin sistema físico (generaliza
+*             sistemaSimulado() de Ejemplo_simulacion):
+*             - plantaPrimerOrden:           K / (Tau s + 1)
+*             - plantaPrimerOrdenRetardo:    K e^(-Retardo s) / (Tau s + 1)
+*             - plantaSegundoOrden:          K Wn^2 / (s^2 + 2 Zeta Wn s + Wn^2)
+*             - plantaEspacioEstados<N>:     x' = A x + B u,  y = C x + D u
+*             Cada objeto es una planta independiente. Simular(ENTRADA, INTERVALO) mantiene la
+*             ENTRADA durante INTERVALO microsegundos (retención de orden cero) usando la
+*             transición discreta exacta, que se calcula sólo cuando cambia el intervalo: con
+*             período constante cada paso son unos pocos productos y sumas.
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_PLANTA_SCA_H
+#define CONTROL_PID_PLANTA_SCA_H
+
+#include "Arduino.h"
+
+#ifndef PLANTA_RETARDO_MAXIMO
+#define PLANTA_RETARDO_MAXIMO 32          // Muestras de retardo que puede guardar una planta
+#endif
+
+class planta                              // Interfaz común de los modelos
+{
+   public:
+   virtual float Simular(float ENTRADA, unsigned long INTERVALO) = 0;
+                                          // Avanza INTERVALO microsegundos con ENTRADA 
+                                          // constante y devuelve la salida.
+   virtual float Salida() = 0;            // Salida actual
+   virtual void  Reiniciar(float SALIDA) = 0;
+                                          // Lleva la planta al reposo con esa salida.
+};
+
+/**************************************************************************************************
+* Primer orden y primer orden con retardo
+**************************************************************************************************/
+
+class plantaPrimerOrden : public planta
+{
+   private:
+   float         Ganancia;
+   float         Tau;                     // En segundos
+   float         Estado;                  // Salida actual
+   unsigned long IntervaloCalculado;      // Intervalo de Decaer (0: sin calcular)
+   float         Decaer;                  // exp(-INTERVALO/Tau)
+
+   public:
+   plantaPrimerOrden(float GANANCIA, float TAU, float INICIAL);
+   float Simular(float ENTRADA, unsigned long INTERVALO);
+   float Salida();
+   void  Reiniciar(float SALIDA);
+};
+
+class plantaPrimerOrdenRetardo : public planta
+{
+   private:
+   plantaPrimerOrden Dinamica;
+   float         Ganancia;                // Para la entrada de reposo en Reiniciar()
+   float         Retardo;                 // En segundos
+   float         Entradas[PLANTA_RETARDO_MAXIMO];   // Entradas anteriores (buffer circular)
+   uint8_t       Indice;
+   uint8_t       Muestras;                // Retardo en muestras para IntervaloCalculado
+   unsigned long IntervaloCalculado;
+
+   public:
+   plantaPrimerOrdenRetardo(float GANANCIA, float TAU, float RETARDO, float INICIAL);
+                                          // El retardo se redondea a un número entero de
+                                          // intervalos (hasta PLANTA_RETARDO_MAXIMO-1).
+   float Simular(float ENTRADA, unsigned long INTERVALO);
+   float Salida();
+   void  Reiniciar(float SALIDA);
+};
+
+/**************************************************************************************************
+* Espacio de estados de orden N
+**************************************************************************************************/
+
+void ExponencialMatriz(const float * M, uint8_t N, float * RESULTADO, float * AUXILIAR);
+                                          // RESULTADO = exp(M), con M de NxN (por filas).
+                                          // AUXILIAR debe tener lugar para 2*N*N float.
+
+template <uint8_t N>
+class plantaEspacioEstados : public planta
+{
+   protected:
+   float         A[N][N];
+   float         B[N];
+   float         C[N];
+   float         D;
+   float         X[N];                    // Estado
+   float         Y;                       // Salida actual
+   unsigned long IntervaloCalculado;      // Intervalo de Ad y Bd (0: sin calcular)
+   float         Ad[N][N];                // exp(A T)
+   float         Bd[N];                   // Integral de exp(A t) B entre 0 y T
+
+   void Discretizar(unsigned long INTERVALO)
+   // exp([A B; 0 0] T) = [Ad Bd; 0 1]: una sola exponencial de orden N+1 da las dos matrices.
+   {
+      const uint8_t M = N + 1;
+      float Aumentada[M*M], Exponencial[M*M], Auxiliar[2*M*M];
+      float T = INTERVALO / 1e6f;
+      for (uint8_t i=0; i<M; i++) {
+         for (uint8_t j=0; j<M; j++) {
+            float V = 0;
+            if (i<N && j<N)  V = A[i][j] * T;
+            if (i<N && j==N) V = B[i] * T;
+            Aumentada[i*M+j] = V;
+         }
+      }
+      ExponencialMatriz(Aumentada, M, Exponencial, Auxiliar);
+      for (uint8_t i=0; i<N; i++) {
+         for (uint8_t j=0; j<N; j++) Ad[i][j] = Exponencial[i*M+j];
+         Bd[i] = Exponencial[i*M+N];
+      }
+      IntervaloCalculado = INTERVALO;
+   }
+
+   public:
+   plantaEspacioEstados()
+   {
+      for (uint8_t i=0; i<N; i++) {
+         for (uint8_t j=0; j<N; j++) A[i][j] = 0;
+         B[i] = 0;
+         C[i] = 0;
+         X[i] = 0;
+      }
+      D = 0;
+      Y = 0;
+      IntervaloCalculado = 0;
+   }
+
+   void Configurar(const float * MATRIZ_A, const float * VECTOR_B, const float * VECTOR_C,
+                   float VALOR_D)         // A por filas (NxN), B y C de N elementos.
+   {
+      for (uint8_t i=0; i<N; i++) {
+         for (uint8_t j=0; j<N; j++) A[i][j] = MATRIZ_A[i*N+j];
+         B[i] = VECTOR_B[i];
+         C[i] = VECTOR_C[i];
+      }
+      D = VALOR_D;
+      IntervaloCalculado = 0;
+   }
+
+   float Simular(float ENTRADA, unsigned long INTERVALO)
+   {
+      float Nuevo[N];
+      if (INTERVALO != IntervaloCalculado) {
+         Discretizar(INTERVALO);
+      }
+      for (uint8_t i=0; i<N; i++) {
+         float S = Bd[i] * ENTRADA;
+         for (uint8_t j=0; j<N; j++) S += Ad[i][j] * X[j];
+         Nuevo[i] = S;
+      }
+      Y = D * ENTRADA;
+      for (uint8_t i=0; i<N; i++) {
+         X[i] = Nuevo[i];
+         Y += C[i] * X[i];
+      }
+      return Y;
+   }
+
+   float Salida()
+   {
+      return Y;
+   }
+
+   void Reiniciar(float SALIDA)
+   // Toma el estado de menor norma que da esa salida (x = C' SALIDA / C C'). Si no es un estado
+   // de reposo para el modelo, fijar el estado deseado con Estado().
+   {
+      float CC = 0;
+      for (uint8_t i=0; i<N; i++) CC += C[i] * C[i];
+      Y = 0;
+      for (uint8_t i=0; i<N; i++) {
+         X[i] = (CC > 0) ? C[i] * SALIDA / CC : 0;
+         Y += C[i] * X[i];
+      }
+   }
+
+   void Estado(const float * ESTADO)      // Fija el estado x
+   {
+      Y = 0;
+      for (uint8_t i=0; i<N; i++) {
+         X[i] = ESTADO[i];
+         Y += C[i] * X[i];
+      }
+   }
+};
+
+/**************************************************************************************************
+* Segundo orden
+**************************************************************************************************/
+
+class plantaSegundoOrden : public plantaEspacioEstados<2>
+{
+   public:
+   plantaSegundoOrden(float GANANCIA, float WN, float ZETA, float INICIAL);
+                                          // WN en rad/s. Arranca en reposo con salida INICIAL.
+   void Reiniciar(float SALIDA);
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_PLANTA_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
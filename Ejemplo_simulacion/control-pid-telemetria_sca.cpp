@@ -0,0 +1,177 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-telemetria_sca.cpp
+* Versión:    3.0 
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-telemetria_sca.h"
+
+#include <string.h>
+
+#define MASCARA_INDICE (TELEMETRIA_CAPACIDAD-1)
+
+/**************************************************************************************************
+* Funciones de trama (usadas también por el decodificador de PC)
+**************************************************************************************************/
+
+uint16_t CRC16Telemetria(const uint8_t * DATOS, uint8_t LARGO)
+{
+   uint16_t CRC = 0xFFFF;
+   for (uint8_t i=0; i<LARGO; i++) {
+      CRC ^= uint16_t(DATOS[i]) << 8;
+      for (uint8_t b=0; b<8; b++) {
+         CRC = (CRC & 0x8000) ? (CRC << 1) ^ 0x1021 : (CRC << 1);
+      }
+   }
+   return CRC;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void ArmarTramaTelemetria(uint8_t SECUENCIA, const pid_registro_s * REGISTRO, uint8_t * TRAMA)
+{
+   uint32_t Tiempo = REGISTRO->Tiempo;
+   float Valores[6] = { REGISTRO->Info.Salida,
+                        REGISTRO->Info.ComponenteProporcional,
+                        REGISTRO->Info.ComponenteIntegral,
+                        REGISTRO->Info.ComponenteDerivativo,
+                        REGISTRO->Info.Compensacion,
+                        REGISTRO->Info.UltimaMedicion };
+   TRAMA[0] = TELEMETRIA_SINCRONISMO_1;
+   TRAMA[1] = TELEMETRIA_SINCRONISMO_2;
+   TRAMA[2] = SECUENCIA;
+   memcpy(&TRAMA[3], &Tiempo, 4);
+   memcpy(&TRAMA[7], Valores, 24);
+   TRAMA[31] = REGISTRO->Info.LimitarSalida ? TELEMETRIA_LIMITAR : 0;
+   uint16_t CRC = CRC16Telemetria(&TRAMA[2], TELEMETRIA_DATOS);
+   TRAMA[32] = CRC & 0xFF;
+   TRAMA[33] = CRC >> 8;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool LeerTramaTelemetria(const uint8_t * TRAMA, uint8_t * SECUENCIA, pid_registro_s * REGISTRO)
+{
+   uint32_t Tiempo;
+   float    Valores[6];
+   if (TRAMA[0] != TELEMETRIA_SINCRONISMO_1 || TRAMA[1] != TELEMETRIA_SINCRONISMO_2) {
+      return false;
+   }
+   uint16_t CRC = TRAMA[32] | (uint16_t(TRAMA[33]) << 8);
+   if (CRC != CRC16Telemetria(&TRAMA[2], TELEMETRIA_DATOS)) {
+      return false;
+   }
+   *SECUENCIA = TRAMA[2];
+   memcpy(&Tiempo, &TRAMA[3], 4);
+   memcpy(Valores, &TRAMA[7], 24);
+   REGISTRO->Tiempo                      = Tiempo;
+   REGISTRO->Info.Salida                 = Valores[0];
+   REGISTRO->Info.ComponenteProporcional = Valores[1];
+   REGISTRO->Info.ComponenteIntegral     = Valores[2];
+   REGISTRO->Info.ComponenteDerivativo   = Valores[3];
+   REGISTRO->Info.Compensacion           = Valores[4];
+   REGISTRO->Info.UltimaMedicion         = Valores[5];
+   REGISTRO->Info.LimitarSalida          = (TRAMA[31] & TELEMETRIA_LIMITAR) != 0;
+   return true;
+}
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+telemetriaPID::telemetriaPID()
+{
+   Escritura   = 0;
+   Lectura     = 0;
+   Decimacion  = 1;
+   Cuenta      = 0;
+   Secuencia   = 0;
+   Enviados    = TELEMETRIA_TRAMA;        // No hay trama pendiente
+   Descartados = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void telemetriaPID::Decimar(uint8_t DECIMACION)
+{
+   Decimacion = (DECIMACION>0) ? DECIMACION : 1;
+   Cuenta = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool telemetriaPID::Registrar(const pid_info_s * INFO)
+{
+   return Registrar(INFO, micros());
+}
+
+bool telemetriaPID::Registrar(const pid_info_s * INFO, unsigned long TIEMPO)
+// Productor. Escribe el registro y recién después avanza Escritura, así el consumidor nunca ve
+// un registro a medio copiar. Los índices son de un byte: se leen y escriben de una vez. La
+// barrera impide que el compilador (o un procesador de varios núcleos) adelante la escritura
+// del índice a la del registro, que no es volatile.
+{
+   if (++Cuenta < Decimacion) {
+      return true;
+   }
+   Cuenta = 0;
+   uint8_t Siguiente = (Escritura + 1) & MASCARA_INDICE;
+   if (Siguiente == Lectura) {
+      Descartados++;
+      return false;
+   }
+   Registros[Escritura].Tiempo = TIEMPO;
+   Registros[Escritura].Info   = *INFO;
+   __sync_synchronize();
+   Escritura = Siguiente;
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned int telemetriaPID::Transmitir(Print & PUERTO)
+// Consumidor. Arma una trama por vez con el registro más antiguo y la envía en la medida en que
+// haya lugar en el buffer de salida del puerto; lo que no entra queda para la próxima llamada.
+// Las barreras ordenan la lectura del registro después de la de Escritura y antes de liberar
+// su lugar con Lectura.
+{
+   unsigned int Total = 0;
+   for (;;) {
+      if (Enviados >= TELEMETRIA_TRAMA) {
+         if (Lectura == Escritura) {
+            break;                        // Nada para enviar
+         }
+         __sync_synchronize();
+         ArmarTramaTelemetria(Secuencia++, &Registros[Lectura], Trama);
+         __sync_synchronize();
+         Lectura  = (Lectura + 1) & MASCARA_INDICE;
+         Enviados = 0;
+      }
+      int Lugar = PUERTO.availableForWrite();
+      if (Lugar <= 0) {
+         break;
+      }
+      uint8_t Cantidad = min(uint8_t(TELEMETRIA_TRAMA - Enviados), uint8_t(min(Lugar, 255)));
+      Cantidad = PUERTO.write(&Trama[Enviados], Cantidad);
+      if (Cantidad == 0) {
+         break;
+      }
+      Enviados += Cantidad;
+      Total    += Cantidad;
+   }
+   return Total;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned long telemetriaPID::Perdidos()
+{
+   return Descartados;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO control-pid-telemetria_sca.cpp
+**************************************************************************************************/
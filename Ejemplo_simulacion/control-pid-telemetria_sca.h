@@ -0,0 +1,77 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-telemetria_sca.h
+* Breve:      Telemetría binaria de controlPID. Registrar() guarda un pid_info_s con su tiempo
+*             en un buffer circular (un productor, un consumidor, sin bloqueos: puede llamarse
+*             desde una interrupción) y Transmitir() lo envía de a poco por el puerto serie, sin
+*             esperar, en tramas con encabezado y CRC. host/decodificar_telemetria convierte la
+*             trama a CSV en la PC.
+* Trama:      0xA5 0x5A | secuencia (1) | tiempo (4) | Salida, ComponenteProporcional,
+*             ComponenteIntegral, ComponenteDerivativo, Compensacion, UltimaMedicion (6 x 4) |
+*             banderas (1) | CRC-16/CCITT de secuencia a banderas (2). Enteros y float en
+*             little-endian (AVR, ARM y x86).
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_TELEMETRIA_SCA_H
+#define CONTROL_PID_TELEMETRIA_SCA_H
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+
+#ifndef TELEMETRIA_CAPACIDAD
+#define TELEMETRIA_CAPACIDAD 8            // Registros en el buffer (potencia de 2, hasta 128)
+#endif
+
+#define TELEMETRIA_SINCRONISMO_1 0xA5
+#define TELEMETRIA_SINCRONISMO_2 0x5A
+#define TELEMETRIA_DATOS         30       // Bytes de secuencia a banderas
+#define TELEMETRIA_TRAMA         (2 + TELEMETRIA_DATOS + 2)
+#define TELEMETRIA_LIMITAR       0x01     // Bandera: LimitarSalida
+
+struct pid_registro_s {                   // Registro guardado en el buffer
+   unsigned long Tiempo;                  // Tiempo de la muestra, en microsegundos
+   pid_info_s    Info;
+};
+
+uint16_t CRC16Telemetria(const uint8_t * DATOS, uint8_t LARGO);
+                                          // CRC-16/CCITT (polinomio 0x1021, inicial 0xFFFF)
+void ArmarTramaTelemetria(uint8_t SECUENCIA, const pid_registro_s * REGISTRO, uint8_t * TRAMA);
+                                          // TRAMA debe tener TELEMETRIA_TRAMA bytes.
+bool LeerTramaTelemetria(const uint8_t * TRAMA, uint8_t * SECUENCIA, pid_registro_s * REGISTRO);
+                                          // Verifica sincronismo y CRC y decodifica.
+
+class telemetriaPID                       // Clase para telemetría binaria
+{
+   private:
+   pid_registro_s   Registros[TELEMETRIA_CAPACIDAD];
+   volatile uint8_t Escritura;            // Sólo la modifica Registrar()
+   volatile uint8_t Lectura;              // Sólo la modifica Transmitir()
+   uint8_t          Decimacion;           // Registra 1 de cada Decimacion muestras
+   uint8_t          Cuenta;
+   uint8_t          Secuencia;
+   uint8_t          Trama[TELEMETRIA_TRAMA];
+   uint8_t          Enviados;             // Bytes de Trama ya enviados
+   unsigned long    Descartados;          // Registros perdidos por buffer lleno
+
+   public:
+   telemetriaPID();
+   void Decimar(uint8_t DECIMACION);      // Registra una de cada DECIMACION muestras (1: todas)
+   bool Registrar(const pid_info_s * INFO);
+   bool Registrar(const pid_info_s * INFO, unsigned long TIEMPO);
+                                          // Guarda una muestra (con micros() o con TIEMPO).
+                                          // Devuelve false si se descartó por buffer lleno.
+   unsigned int Transmitir(Print & PUERTO);
+                                          // Envía lo que entra en el buffer de PUERTO sin
+                                          // esperar (usa availableForWrite) y devuelve los
+                                          // bytes enviados. Llamar seguido desde loop().
+   unsigned long Perdidos();              // Registros descartados por buffer lleno
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_TELEMETRIA_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
@@ -17,8 +17,18 @@
 #ifndef CONTROL_PID_SCA_H
 #define CONTROL_PID_SCA_H
 
+#include "control-pid-salida_sca.h"
+
 #define PID_SIN_SALIDA 0
 
+#ifndef PID_ESTADISTICAS
+#define PID_ESTADISTICAS 0                // 1 para medir tiempos e intervalos de Controlar()
+#endif
+#define PID_HISTOGRAMA_CLASES 8           // Clases del histograma de intervalos
+#ifndef PID_EVENTOS
+#define PID_EVENTOS 0                     // 1 para el modo por eventos (Eventos())
+#endif
+
 struct pid_config_s {
    float Objetivo;            // Salida Objetivo del sistema.
    float Kp;                  // Constante de proporcionalidad (puede ser negativo)
@@ -29,6 +39,18 @@ struct pid_config_s {
    bool  CompensarIntegral;   // true si se desea compensar la integral ante enrole
 };
 
+struct pid_coeficientes_s {         // Coeficientes discretos, calculados al configurar.
+   float Kp;                  // Kp de la configuración
+   float Derivativo;          // Kp*Td*MILLON, dividido por el período si éste es fijo
+   float Integral;            // 1/(2*Ti*MILLON), multiplicado por el período si es fijo (0 si Ti=0)
+   float IntegralKp;          // Kp*Integral
+};
+
+void CalcularCoeficientesPID(const pid_config_s * CONFIG, unsigned long PERIODO, 
+                             pid_coeficientes_s * COEF);
+                              // Calcula los coeficientes discretos de CONFIG para el PERIODO
+                              // fijo en microsegundos (0 si el intervalo se mide en cada llamada)
+
 struct pid_info_s {
    float Salida;                 // La señal de control que va al acuador
                                  // o potencia de salida (sin asignar unidades)
@@ -41,40 +63,209 @@ struct pid_info_s {
    bool  LimitarSalida;
 };
 
+#if PID_ESTADISTICAS
+struct pid_estadisticas_s {
+   unsigned long Llamadas;                // Cantidad de llamadas a Controlar(), incluidas
+                                          // las omitidas en el modo por eventos
+   unsigned long TiempoMinimo;            // Duración de Controlar(), en microsegundos
+   unsigned long TiempoMaximo;
+   float         TiempoMedio;
+   unsigned long Histograma[PID_HISTOGRAMA_CLASES];
+                                          // Intervalos entre llamadas. La primera clase cuenta
+                                          // los menores que Nominal-Tolerancia, la última los
+                                          // mayores que Nominal+Tolerancia y el resto divide 
+                                          // ese rango en partes iguales.
+   unsigned long FueraDeTolerancia;       // Intervalos en la primera o la última clase
+   unsigned long MuestrasSaturadas;       // Llamadas en que la salida superó un límite
+};
+#endif
+
+template <uint8_t N> class reservaPID;   // control-pid-reserva_sca.h
+
+struct pid_nodo_s {                       // Coeficientes discretos en un nodo de una grilla
+   float Kp;
+   float Derivativo;
+   float Integral;
+};
+
+struct pid_grilla_s {                     // Grilla uniforme de coeficientes según una variable
+   const pid_nodo_s * Nodos;
+   const float *      Variable;           // 0: la variable es la medición
+   float              Minimo;             // Variable del primer nodo
+   float              InversoPaso;        // Nodos por unidad de la variable (0: un solo punto)
+   uint8_t            Cantidad;           // Nodos (al menos 2)
+};
+
+class proveedorCoeficientesPID            // Coeficientes que cambian en cada muestra, por ejemplo
+{                                         // con ganancias programadas (controlPIDProgramado)
+   public:
+   pid_grilla_s Grilla;                   // controlPID la interpola antes de cada muestra
+                                          // evaluada, sin llamadas virtuales. Los coeficientes
+                                          // que valen 0 desactivan ese término.
+   virtual void Calcular(const pid_config_s * CONFIG, unsigned long PERIODO) = 0;
+                                          // Cambió la configuración o el período fijo:
+                                          // actualiza Grilla.
+};
+
 class controlPID                          // Clase para control PID
 {  
    private:
-   pid_config_s  Configuracion;           // Parámetros configurados.    
-   pid_info_s    Admin;                   // Variables de administración del control PID
-   uint8_t       PinSalida;
-   bool          LimitarSalida;
-   unsigned long TiempoActual;          
-   unsigned long TiempoAnterior;          // Tiempo de la medición anterior utilizando micros
-   float         Error;
+   // Sólo el estado que pasa de una muestra a la siguiente (error, tiempo e integral); los
+   // valores de una sola llamada son locales de ControlarEn() y el componente proporcional se
+   // calcula en Leer(). Los miembros más alineados van primero para no dejar relleno.
+   unsigned long PeriodoMuestreo;         // Período fijo en microsegundos (0: se mide con micros)
+   unsigned long TiempoAnterior;          // Tiempo de la medición anterior (reloj o período fijo)
+   unsigned long (*LeerReloj)();          // Reloj en microsegundos (micros() predeterminado)
+   proveedorCoeficientesPID * Proveedor;  // 0: coeficientes fijos de la configuración
+   salidaPWM     Etapa;                   // Pin, escala y último valor del PWM
+   float         Salida;                  // Última salida, ya limitada
+   float         ComponenteIntegral;
+   float         ComponenteDerivativo;    // Último término derivativo (sólo para Leer)
+   float         UltimaMedicion;
    float         ErrorAnterior;           // Señal de error anterior 
    float         CompensacionAnterior;    // Como usamos aproximación trapezoidal de la integral,
+   pid_coeficientes_s Coeficientes;       // Coeficientes precalculados para Controlar()
+   pid_config_s  Configuracion;           // Parámetros configurados.    
+   pid_config_s  ConfiguracionPendiente;  // Cargada por Reconfigurar(), se aplica en Controlar()
+   volatile uint8_t SecuenciaPendiente;   // Impar mientras Reconfigurar() escribe
+   volatile bool HayPendiente;            // ConfiguracionPendiente todavía no se aplicó
+   bool          LimitarSalida;
+   bool          MuestraAnterior;         // Hubo una muestra desde Configurar() o Apagar()
+   void Iniciar(uint8_t PIN_SALIDA);      // Cuerpo del constructor (también para reservaPID).
+   void CargarConfiguracion(pid_config_s *CONFIG);
+                                          // Copia y verifica CONFIG sin tocar el estado.
+   void AplicarPendiente();               // Aplica la configuración de Reconfigurar(), si hay.
+   void CalcularCoeficientes();           // Precalcula Coeficientes según configuración y período.
+   void EscribirSalida();                 // Escribe Salida en el PWM (si corresponde).
+   template <uint8_t N> friend class reservaPID;
+#if PID_EVENTOS
+   unsigned long SilencioMaximo;          // Microsegundos sin evaluar (0: sin límite)
+   unsigned long TiempoEvaluacion;        // Tiempo de la última evaluación
+   unsigned long Consecutivas;            // Muestras omitidas desde la última evaluación
+   unsigned long Omitidas;                // Muestras omitidas desde Eventos()
+   float         BandaEventos;            // 0: evalúa todas las muestras
+   float         ObjetivoEvaluado;        // Objetivo de la última evaluación
+   bool          EvaluarProxima;          // Hubo una reconfiguración: no se omite
+   bool Omitir(unsigned long TIEMPO, float MEDICION);
+                                          // Decide si la muestra se omite y, si es así, la
+                                          // registra.
+#endif
+#if PID_ESTADISTICAS
+   pid_estadisticas_s Estadisticas;
+   unsigned long TiempoTotal;             // Suma de duraciones, para el promedio
+   unsigned long EntradaAnterior;         // micros() al entrar en la llamada anterior
+   unsigned long IntervaloNominal;        // Intervalo esperado (0: usa PeriodoMuestreo)
+   unsigned long Tolerancia;              // Desvío aceptado del intervalo
+   void RegistrarEstadisticas(unsigned long ENTRADA, bool SATURADA);
+#endif
       
    public:
-   controlPID(uint8_t PIN_SALIDA);        // Constructor con PIN de salida.
+   controlPID(uint8_t PIN_SALIDA = PID_SIN_SALIDA);
+                                          // Constructor con PIN de salida.
                                           // - PIN_SALIDA debe ser un PWM válido de Arduino.
                                           // - Si PIN_SALIDA = 0, no modifica nivel de PWM.
-   void Configurar(pid_config_s *CONFIG); // Configura todos los parámetros.
+   void Configurar(pid_config_s *CONFIG); // Configura todos los parámetros. Reinicia el cálculo
+                                          // (derivada e integral) y pone el PWM en 0.
+   void Reconfigurar(const pid_config_s *CONFIG);
+                                          // Prepara una nueva configuración que se aplica al
+                                          // comienzo del próximo Controlar(), sin reiniciar el
+                                          // cálculo y sin salto en la salida. Se puede llamar
+                                          // desde otro contexto (interrupción) que Controlar(),
+                                          // pero siempre desde el mismo: con dos contextos que
+                                          // la llamen, una puede interrumpir a la otra y
+                                          // mezclar las dos configuraciones.
+   bool ReconfiguracionPendiente();       // Indica si hay una configuración sin aplicar.
    void Obtener(pid_config_s *CONFIG);    // Obtiene los parámetros configurados.
    bool CompensarIntegral(bool COMPENSAR); 
                                           // Activa o desactiva la compansación de integración 
                                           // e indica si está activado:
    bool CompensarIntegral();              // Indica si la compansación está activada.
+   unsigned long PeriodoFijo(unsigned long PERIODO);
+                                          // Declara que Controlar() se llama cada PERIODO 
+                                          // microsegundos: no lee micros() ni divide por el 
+                                          // intervalo. Si PERIODO = 0, vuelve a medir el tiempo.
+   unsigned long PeriodoFijo();           // Indica el período fijo (0 si se mide el tiempo).
+   unsigned long TiempoMuestra();         // Tiempo (micros) con que se calculó la última muestra.
+   void Reloj(unsigned long (*RELOJ)());  // Reloj con que se mide el intervalo sin período fijo,
+                                          // en microsegundos (0: micros()). Por ejemplo, un
+                                          // reloj virtual para simular más rápido que el tiempo
+                                          // real.
+   unsigned long TiempoActual();          // Lee ese reloj (para quien acompaña al controlador,
+                                          // como autoajustePID).
+   void ProveedorCoeficientes(proveedorCoeficientesPID * PROVEEDOR);
+                                          // Antes de cada muestra evaluada, Kp y los
+                                          // coeficientes discretos se interpolan en la grilla
+                                          // de PROVEEDOR (0: vuelven a los de la
+                                          // configuración). Sin proveedor no hay costo extra.
    float Controlar(float MEDICION, float OBJETIVO);  
                                           // Calcula señal de control en función de la MEDICION y
                                           // el OBJETIVO. Configura el objetivo actual.
    float Controlar(float MEDICION);       // Calcula señal de control en función de la MEDICION.
                                           // Si Objetivo está configurado en 0, puede utilizarse 
                                           // como MEDICION-Objetivo = -ERROR
+   float ControlarEn(unsigned long TIEMPO, float MEDICION);
+                                          // Como Controlar(MEDICION), con el tiempo de la muestra
+                                          // en microsegundos en lugar de leer el reloj: el
+                                          // resultado depende sólo de los argumentos y del
+                                          // estado. Con período fijo, TIEMPO sólo se registra.
+   float ControlarEn(unsigned long TIEMPO, float MEDICION, float OBJETIVO);
+   uint8_t ResolucionPWM(uint8_t BITS);   // Bits del PWM (PID_PWM_BITS predeterminado). El
+                                          // límite inferior escribe 0 y el superior 2^BITS-1.
+   void RegistroPWM(volatile uint8_t * REGISTRO);
+   void RegistroPWM(volatile uint16_t * REGISTRO);
+                                          // Escribe el PWM directamente en el registro de
+                                          // comparación del timer (p. ej. &OCR1A), que el
+                                          // programa ya configuró. 0: vuelve a analogWrite().
+   float SalidaManual(float SALIDA);      // Impone la salida (limitada) sin calcular el PID.
    void Apagar();                         // Apaga el PID manteniendo configuración.
    void Leer(pid_info_s * INFO);          // Lee la acción de control, componente proporcional, 
-                                          // integral y otros datos de funcionamiento.
+                                          // integral y otros datos de funcionamiento. El
+                                          // proporcional se calcula con la Kp vigente.
+#if PID_EVENTOS
+   void Eventos(float BANDA, unsigned long SILENCIO);
+                                          // Modo por eventos (send-on-delta): ControlarEn() sólo
+                                          // calcula y escribe si la medición o el objetivo se
+                                          // apartaron más de BANDA de los de la última
+                                          // evaluación, o si pasaron SILENCIO microsegundos
+                                          // (0: sin límite); si no, devuelve la salida
+                                          // anterior. La integral de la próxima evaluación
+                                          // agrega el tiempo omitido con el error retenido, y
+                                          // su derivada divide el cambio del error por el
+                                          // tiempo desde la evaluación anterior. BANDA = 0
+                                          // evalúa todas las muestras. Reinicia la cuenta.
+   void ObtenerEventos(float * BANDA, unsigned long * SILENCIO);
+                                          // Banda y silencio dados a Eventos().
+   unsigned long EvaluacionesOmitidas();  // Muestras omitidas desde Eventos().
+#endif
+#if PID_ESTADISTICAS
+   void ConfigurarEstadisticas(unsigned long NOMINAL, unsigned long TOLERANCIA);
+                                          // Intervalo esperado entre llamadas y desvío aceptado,
+                                          // en microsegundos. Reinicia las estadísticas.
+   void LeerEstadisticas(pid_estadisticas_s * ESTADISTICAS);
+                                          // Lee tiempos de ejecución, histograma de intervalos
+                                          // y cantidad de muestras saturadas.
+   void ReiniciarEstadisticas();
+#endif
 };
 
+// Presupuesto de memoria de controlPID en bytes, fijo por plataforma: un campo nuevo (o un
+// cambio de tipo o de orden que agregue relleno) no compila hasta que se actualice aquí a
+// conciencia. Valores: base, con PID_EVENTOS, con PID_ESTADISTICAS y con los dos.
+#define PID_ELEGIR_PRESUPUESTO(BASE, EVENTOS, ESTADISTICAS, AMBOS)                         \
+        ( PID_ESTADISTICAS ? (PID_EVENTOS ? (AMBOS)   : (ESTADISTICAS))                    \
+                           : (PID_EVENTOS ? (EVENTOS) : (BASE)) )
+#ifndef PID_PRESUPUESTO_BYTES
+#if defined(__AVR__)                      // 8 bits (ATmega328: 2 KB de SRAM)
+#define PID_PRESUPUESTO_BYTES PID_ELEGIR_PRESUPUESTO(125, 150, 197, 222)
+#elif __SIZEOF_LONG__ == 8                // PC de 64 bits (host/)
+#define PID_PRESUPUESTO_BYTES PID_ELEGIR_PRESUPUESTO(168, 216, 312, 360)
+#else                                     // 32 bits (ARM, ESP32)
+#define PID_PRESUPUESTO_BYTES PID_ELEGIR_PRESUPUESTO(140, 168, 212, 240)
+#endif
+#endif
+static_assert(sizeof(controlPID) <= PID_PRESUPUESTO_BYTES, 
+              "controlPID supera PID_PRESUPUESTO_BYTES: revisar los miembros agregados");
+
 /*************************************************************************************************/
 
 #endif // CONTROL_SINO_H
@@ -0,0 +1,202 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-autoajuste_sca.cpp
+* Versión:    3.0 
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-autoajuste_sca.h"
+
+const float PI_AUTOAJUSTE = 3.14159265f;
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+autoajustePID::autoajustePID()
+{
+   PID    = 0;
+   Estado = AUTOAJUSTE_INACTIVO;
+   Ku     = 0;
+   Pu     = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+uint8_t autoajustePID::Iniciar(controlPID * PID_A_AJUSTAR, float HISTERESIS, uint8_t CICLOS, 
+                               uint8_t REGLA, unsigned long LIMITE_TIEMPO)
+// Guarda la configuración vigente y arranca el relé. Falla si no hay límites de salida, ya
+// que el relé conmuta entre ellos.
+{
+   PID = PID_A_AJUSTAR;
+   PID->Obtener(&Configuracion);
+   if (Configuracion.LimiteSuperior == Configuracion.LimiteInferior || CICLOS == 0) {
+      Estado = AUTOAJUSTE_FALLIDO;
+      return Estado;
+   }
+   Histeresis     = fabs(HISTERESIS);
+   CiclosPedidos  = CICLOS;
+   Regla          = REGLA;
+   LimiteTiempo   = LIMITE_TIEMPO;
+   Ciclos         = 0;
+   SumaPeriodos   = 0;
+   SumaAmplitudes = 0;
+   Ku             = 0;
+   Pu             = 0;
+   Tiempo         = PID->TiempoMuestra(); // Con período fijo, Ejecutar() sigue desde aquí
+   Inicio         = Tiempo;
+   TiempoSubida   = Tiempo;
+   Primera        = true;
+   Estado         = AUTOAJUSTE_EN_CURSO;
+   PID->Apagar();
+   Alto = false;                          // Se decide con la primera medición
+   Maximo = -1e30f;
+   Minimo =  1e30f;
+   return Estado;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+uint8_t autoajustePID::Ejecutar(float MEDICION)
+// Con período fijo el tiempo avanza sin leer el reloj, igual que en Controlar(); si no, se lee
+// el reloj del controlador.
+{
+   if (PID != 0 && PID->PeriodoFijo() > 0) {
+      return EjecutarEn(Tiempo + PID->PeriodoFijo(), MEDICION);
+   }
+   return EjecutarEn(PID ? PID->TiempoActual() : 0, MEDICION);
+}
+
+uint8_t autoajustePID::EjecutarEn(unsigned long TIEMPO, float MEDICION)
+// El relé sube la salida cuando el error supera la histéresis y la baja cuando es menor que
+// -histéresis (al revés si Kp es negativo). Cada subida cierra un ciclo: se registran su
+// período y la amplitud pico a pico de la medición. El ciclo que termina en la segunda subida
+// se descarta, porque contiene el ascenso desde el reposo.
+{
+   if (Estado != AUTOAJUSTE_EN_CURSO) return Estado;
+   
+   Tiempo = TIEMPO;
+   if (Primera) {
+      Inicio  = Tiempo;
+      Primera = false;
+   }
+   if (LimiteTiempo > 0 && (Tiempo - Inicio) > LimiteTiempo) {
+      Cancelar();
+      Estado = AUTOAJUSTE_FALLIDO;
+      return Estado;
+   }
+   
+   float Error = Configuracion.Objetivo - MEDICION;
+   if (Configuracion.Kp < 0) Error = -Error;
+   Maximo = max(Maximo, MEDICION);
+   Minimo = min(Minimo, MEDICION);
+   
+   if (!Alto && Error > Histeresis) {
+      // La primera subida no cierra ningún ciclo y la segunda cierra el que arranca del reposo
+      if (Ciclos > 1) {
+         SumaPeriodos   = SumaPeriodos + (Tiempo - TiempoSubida) / 1e6f;
+         SumaAmplitudes = SumaAmplitudes + (Maximo - Minimo) / 2;
+      }
+      Ciclos++;
+      TiempoSubida = Tiempo;
+      Maximo = MEDICION;
+      Minimo = MEDICION;
+      Conmutar(true);
+      if (Ciclos > CiclosPedidos + 1) {
+         Terminar();
+      }
+   } else if (Alto && Error < -Histeresis) {
+      Conmutar(false);
+   } else {
+      Conmutar(Alto);
+   }
+   return Estado;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void autoajustePID::Cancelar()
+{
+   if (PID) PID->Apagar();
+   Estado = AUTOAJUSTE_INACTIVO;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+uint8_t autoajustePID::EstadoActual()
+{
+   return Estado;
+}
+
+float autoajustePID::GananciaCritica()
+{
+   return Ku;
+}
+
+float autoajustePID::PeriodoCritico()
+{
+   return Pu;
+}
+
+void autoajustePID::Resultado(pid_config_s * CONFIG)
+{
+   *CONFIG = Configuracion;
+}
+
+/**************************************************************************************************
+* Funciones privadas
+**************************************************************************************************/
+
+void autoajustePID::Conmutar(bool ALTO)
+{
+   Alto = ALTO;
+   bool Superior = (Alto == (Configuracion.Kp >= 0));
+   PID->SalidaManual( Superior ? Configuracion.LimiteSuperior : Configuracion.LimiteInferior );
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void autoajustePID::Terminar()
+// Ku = 4d / (pi * sqrt(a^2 - e^2)), con d la amplitud del relé, a la de la oscilación y e la
+// histéresis. Luego aplica la regla elegida, manteniendo objetivo, límites y compensación.
+{
+   float Amplitud = SumaAmplitudes / CiclosPedidos;
+   float Rele     = (Configuracion.LimiteSuperior - Configuracion.LimiteInferior) / 2;
+   float Efectiva = Amplitud*Amplitud - Histeresis*Histeresis;
+   
+   Pu = SumaPeriodos / CiclosPedidos;
+   if (Efectiva <= 0 || Pu <= 0) {
+      Cancelar();
+      Estado = AUTOAJUSTE_FALLIDO;
+      return;
+   }
+   Ku = 4 * Rele / ( PI_AUTOAJUSTE * sqrt(Efectiva) );
+   
+   float Signo = (Configuracion.Kp < 0) ? -1 : 1;
+   switch (Regla) {
+      case REGLA_ZN_PI:
+         Configuracion.Kp = Signo * 0.45f * Ku;
+         Configuracion.Ti = Pu / 1.2f;
+         Configuracion.Td = 0;
+         break;
+      case REGLA_SIN_SOBREPICO:
+         Configuracion.Kp = Signo * 0.2f * Ku;
+         Configuracion.Ti = Pu / 2;
+         Configuracion.Td = Pu / 3;
+         break;
+      default:
+         Configuracion.Kp = Signo * 0.6f * Ku;
+         Configuracion.Ti = Pu / 2;
+         Configuracion.Td = Pu / 8;
+         break;
+   }
+   PID->Apagar();
+   PID->Configurar(&Configuracion);
+   Estado = AUTOAJUSTE_TERMINADO;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO control-pid-autoajuste_sca.cpp
+**************************************************************************************************/
@@ -0,0 +1,83 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-autoajuste_sca.h
+* Breve:      Autoajuste de un controlPID por realimentación con relé (método de Åström-Hägglund).
+*             Durante el ensayo la salida conmuta entre LimiteSuperior y LimiteInferior (por el
+*             mismo PinSalida del controlPID) según la medición esté de uno u otro lado del
+*             Objetivo. De la oscilación resultante se obtienen la ganancia crítica Ku y el
+*             período crítico Pu, y con ellos una sintonía Ziegler-Nichols que se aplica con
+*             Configurar().
+* Uso:        Configurar el controlPID con Objetivo y límites; llamar a Iniciar() y luego a
+*             Ejecutar(MEDICION) en cada muestra en lugar de Controlar() (o EjecutarEn() en lugar
+*             de ControlarEn()), hasta que devuelva AUTOAJUSTE_TERMINADO (o AUTOAJUSTE_FALLIDO).
+*             El tiempo es el del controlador: su período fijo, su Reloj() o el TIEMPO explícito.
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_AUTOAJUSTE_SCA_H
+#define CONTROL_PID_AUTOAJUSTE_SCA_H
+
+#include "control-pid_sca.h"
+
+// Estados del autoajuste
+#define AUTOAJUSTE_INACTIVO  0
+#define AUTOAJUSTE_EN_CURSO  1
+#define AUTOAJUSTE_TERMINADO 2
+#define AUTOAJUSTE_FALLIDO   3
+
+// Reglas de sintonía a partir de Ku y Pu
+#define REGLA_ZN_PI          0      // Ziegler-Nichols PI:  Kp=0.45Ku, Ti=Pu/1.2
+#define REGLA_ZN_PID         1      // Ziegler-Nichols PID: Kp=0.6Ku,  Ti=Pu/2, Td=Pu/8
+#define REGLA_SIN_SOBREPICO  2      // PID sin sobrepico:   Kp=0.2Ku,  Ti=Pu/2, Td=Pu/3
+
+class autoajustePID                       // Clase para autoajuste por relé
+{
+   private:
+   controlPID *  PID;                     // Controlador a sintonizar
+   pid_config_s  Configuracion;           // Configuración al iniciar (objetivo y límites)
+   uint8_t       Estado;
+   uint8_t       Regla;
+   uint8_t       CiclosPedidos;           // Ciclos a promediar (sin contar el primero)
+   uint16_t      Ciclos;                  // Subidas del relé observadas
+   bool          Primera;                 // Todavía no hubo muestras
+   float         Histeresis;              // Banda alrededor del objetivo para conmutar
+   bool          Alto;                    // Relé en LimiteSuperior
+   unsigned long Tiempo;                  // Tiempo actual en microsegundos
+   unsigned long TiempoSubida;            // Instante de la última conmutación hacia alto
+   unsigned long LimiteTiempo;            // Duración máxima del ensayo (0: sin límite)
+   unsigned long Inicio;                  // Tiempo de la primera muestra
+   float         Maximo;                  // Extremos de la medición en el ciclo en curso
+   float         Minimo;
+   float         SumaPeriodos;            // Acumulados de los ciclos promediados, en segundos
+   float         SumaAmplitudes;
+   float         Ku;
+   float         Pu;
+   
+   void Conmutar(bool ALTO);
+   void Terminar();
+
+   public:
+   autoajustePID();
+   uint8_t Iniciar(controlPID * PID_A_AJUSTAR, float HISTERESIS, uint8_t CICLOS, 
+                   uint8_t REGLA, unsigned long LIMITE_TIEMPO);
+                                          // Comienza el ensayo. Requiere límites distintos.
+                                          // LIMITE_TIEMPO en microsegundos (0: sin límite).
+   uint8_t Ejecutar(float MEDICION);      // Avanza el ensayo con una medición (reemplaza a 
+                                          // Controlar) y devuelve el estado.
+   uint8_t EjecutarEn(unsigned long TIEMPO, float MEDICION);
+                                          // Como Ejecutar(), con el tiempo de la muestra en
+                                          // microsegundos (reemplaza a ControlarEn).
+   void Cancelar();                       // Interrumpe el ensayo y apaga el PID.
+   uint8_t EstadoActual();                // Estado actual del autoajuste.
+   float GananciaCritica();               // Ku (0 si no terminó)
+   float PeriodoCritico();                // Pu en segundos (0 si no terminó)
+   void Resultado(pid_config_s * CONFIG); // Configuración calculada y aplicada al terminar.
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_AUTOAJUSTE_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
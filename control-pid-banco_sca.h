@@ -0,0 +1,321 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-banco_sca.h
+* Breve:      Banco de N lazos PID independientes que se evalúan juntos en cada tic.
+*             Los datos de cada lazo se guardan en arreglos separados (Kp, coeficientes, límites,
+*             integrales, errores anteriores...) para recorrerlos de a varios lazos por vez con
+*             instrucciones vectoriales: AVX (8 lazos) o SSE2 (4 lazos) en x86. En otros
+*             procesadores se usa el mismo cálculo escalar de controlPID.
+*             Los resultados son idénticos bit a bit a los de N objetos controlPID configurados
+*             con el mismo PeriodoFijo(), siempre que el compilador no fusione productos y sumas
+*             (no usar -mfma ni -march=native sin -ffp-contract=off).
+*             Todos los lazos comparten el período de muestreo. No maneja pines de salida.
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_BANCO_SCA_H
+#define CONTROL_PID_BANCO_SCA_H
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+
+#if defined(__AVX__)
+   #include <immintrin.h>
+   #define PID_BANCO_ANCHO 8
+#elif defined(__SSE2__)
+   #include <emmintrin.h>
+   #define PID_BANCO_ANCHO 4
+#else
+   #define PID_BANCO_ANCHO 1
+#endif
+
+/**************************************************************************************************
+* Operaciones vectoriales mínimas. Las máscaras de comparación valen todos unos (verdadero) o
+* cero (falso) en cada carril.
+**************************************************************************************************/
+
+#if defined(__AVX__)
+   typedef __m256 pid_vector_t;
+   inline pid_vector_t PID_Cargar(const float * P)             { return _mm256_load_ps(P); }
+   inline void PID_Guardar(float * P, pid_vector_t A)          { _mm256_store_ps(P, A); }
+   inline pid_vector_t PID_CargarDesalineado(const float * P)  { return _mm256_loadu_ps(P); }
+   inline void PID_GuardarDesalineado(float * P, pid_vector_t A) { _mm256_storeu_ps(P, A); }
+   inline pid_vector_t PID_Repetir(float X)                    { return _mm256_set1_ps(X); }
+   inline pid_vector_t PID_Sumar(pid_vector_t A, pid_vector_t B)       { return _mm256_add_ps(A, B); }
+   inline pid_vector_t PID_Restar(pid_vector_t A, pid_vector_t B)      { return _mm256_sub_ps(A, B); }
+   inline pid_vector_t PID_Multiplicar(pid_vector_t A, pid_vector_t B) { return _mm256_mul_ps(A, B); }
+   inline pid_vector_t PID_Minimo(pid_vector_t A, pid_vector_t B)      { return _mm256_min_ps(A, B); }
+   inline pid_vector_t PID_Maximo(pid_vector_t A, pid_vector_t B)      { return _mm256_max_ps(A, B); }
+   inline pid_vector_t PID_Mayor(pid_vector_t A, pid_vector_t B)  { return _mm256_cmp_ps(A, B, _CMP_GT_OQ); }
+   inline pid_vector_t PID_Menor(pid_vector_t A, pid_vector_t B)  { return _mm256_cmp_ps(A, B, _CMP_LT_OQ); }
+   inline pid_vector_t PID_Y(pid_vector_t A, pid_vector_t B)           { return _mm256_and_ps(A, B); }
+   inline pid_vector_t PID_Elegir(pid_vector_t M, pid_vector_t A, pid_vector_t B)
+                                                               { return _mm256_blendv_ps(B, A, M); }
+#elif defined(__SSE2__)
+   typedef __m128 pid_vector_t;
+   inline pid_vector_t PID_Cargar(const float * P)             { return _mm_load_ps(P); }
+   inline void PID_Guardar(float * P, pid_vector_t A)          { _mm_store_ps(P, A); }
+   inline pid_vector_t PID_CargarDesalineado(const float * P)  { return _mm_loadu_ps(P); }
+   inline void PID_GuardarDesalineado(float * P, pid_vector_t A) { _mm_storeu_ps(P, A); }
+   inline pid_vector_t PID_Repetir(float X)                    { return _mm_set1_ps(X); }
+   inline pid_vector_t PID_Sumar(pid_vector_t A, pid_vector_t B)       { return _mm_add_ps(A, B); }
+   inline pid_vector_t PID_Restar(pid_vector_t A, pid_vector_t B)      { return _mm_sub_ps(A, B); }
+   inline pid_vector_t PID_Multiplicar(pid_vector_t A, pid_vector_t B) { return _mm_mul_ps(A, B); }
+   inline pid_vector_t PID_Minimo(pid_vector_t A, pid_vector_t B)      { return _mm_min_ps(A, B); }
+   inline pid_vector_t PID_Maximo(pid_vector_t A, pid_vector_t B)      { return _mm_max_ps(A, B); }
+   inline pid_vector_t PID_Mayor(pid_vector_t A, pid_vector_t B)       { return _mm_cmpgt_ps(A, B); }
+   inline pid_vector_t PID_Menor(pid_vector_t A, pid_vector_t B)       { return _mm_cmplt_ps(A, B); }
+   inline pid_vector_t PID_Y(pid_vector_t A, pid_vector_t B)           { return _mm_and_ps(A, B); }
+   inline pid_vector_t PID_Elegir(pid_vector_t M, pid_vector_t A, pid_vector_t B)
+                                    { return _mm_or_ps(_mm_and_ps(M, A), _mm_andnot_ps(M, B)); }
+#endif
+
+/**************************************************************************************************
+* Banco de N lazos
+**************************************************************************************************/
+
+template <unsigned int N>
+class controlPIDBanco
+{
+   private:
+   // Cantidad de lazos redondeada al ancho vectorial; los de relleno no se evalúan.
+   static const unsigned int NR = (N + PID_BANCO_ANCHO - 1) / PID_BANCO_ANCHO * PID_BANCO_ANCHO;
+
+   unsigned long Periodo;                          // Período de muestreo común, en microsegundos
+
+   // Configuración (máscaras: todos los bits en 1 = verdadero, en 0 = falso)
+   alignas(32) float Objetivos[NR];
+   alignas(32) float Kp[NR];
+   alignas(32) float CoefDerivativo[NR];           // Ver pid_coeficientes_s
+   alignas(32) float CoefIntegral[NR];
+   alignas(32) float CoefIntegralKp[NR];
+   alignas(32) float LimiteSuperior[NR];
+   alignas(32) float LimiteInferior[NR];
+   alignas(32) float Derivar[NR];                  // Máscara: Td != 0
+   alignas(32) float Integrar[NR];                 // Máscara: Ti != 0
+   alignas(32) float Compensar[NR];                // Máscara: CompensarIntegral
+   alignas(32) float Limitar[NR];                  // Máscara: LimitarSalida
+
+   // Estado
+   alignas(32) float Iniciado[NR];                 // Máscara: ya hubo una muestra anterior
+   alignas(32) float ErrorAnterior[NR];
+   alignas(32) float CompensacionAnterior[NR];
+   alignas(32) float Integral[NR];
+   alignas(32) float Derivativo[NR];
+   alignas(32) float Salida[NR];
+   alignas(32) float UltimaMedicion[NR];
+
+   static float Mascara(bool CONDICION)
+   {
+      union { uint32_t Entero; float Real; } M;
+      M.Entero = CONDICION ? 0xFFFFFFFFu : 0;
+      return M.Real;
+   }
+   static bool Verdadero(float MASCARA)
+   {
+      union { uint32_t Entero; float Real; } M;
+      M.Real = MASCARA;
+      return M.Entero != 0;
+   }
+
+   void ControlarEscalar(unsigned int INICIO, unsigned int FIN, const float * MEDICIONES,
+                         float * SALIDAS);
+
+   public:
+   controlPIDBanco(unsigned long PERIODO);         // Todos los lazos con Kp=1 y sin límites
+   void Configurar(unsigned int LAZO, pid_config_s * CONFIG);
+                                                   // Configura un lazo (igual que controlPID)
+   void Objetivo(unsigned int LAZO, float OBJETIVO);
+   void Controlar(const float * MEDICIONES, float * SALIDAS);
+                                                   // Evalúa los N lazos: MEDICIONES y SALIDAS
+                                                   // son arreglos de N elementos.
+   void Apagar(unsigned int LAZO);                 // Apaga un lazo manteniendo su configuración
+   void Leer(unsigned int LAZO, pid_info_s * INFO);
+   unsigned int Cantidad() const { return N; }
+};
+
+//-------------------------------------------------------------------------------------------------
+
+template <unsigned int N>
+controlPIDBanco<N>::controlPIDBanco(unsigned long PERIODO)
+{
+   Periodo = PERIODO;
+   for (unsigned int i=0; i<NR; i++) {
+      pid_config_s Config = {};
+      Config.Kp = 1;
+      Integral[i] = 0;
+      Configurar(i, &Config);
+      Apagar(i);
+   }
+}
+
+template <unsigned int N>
+void controlPIDBanco<N>::Configurar(unsigned int LAZO, pid_config_s * CONFIG)
+{
+   pid_coeficientes_s Coef;
+   if (CONFIG->LimiteSuperior < CONFIG->LimiteInferior) {
+      float SW = CONFIG->LimiteSuperior;
+      CONFIG->LimiteSuperior = CONFIG->LimiteInferior;
+      CONFIG->LimiteInferior = SW;
+   }
+   bool LimitarSalida = (CONFIG->LimiteSuperior != CONFIG->LimiteInferior);
+   CONFIG->CompensarIntegral = CONFIG->CompensarIntegral && LimitarSalida;
+   CalcularCoeficientesPID(CONFIG, Periodo, &Coef);
+
+   Objetivos[LAZO]      = CONFIG->Objetivo;
+   Kp[LAZO]             = CONFIG->Kp;
+   CoefDerivativo[LAZO] = Coef.Derivativo;
+   CoefIntegral[LAZO]   = Coef.Integral;
+   CoefIntegralKp[LAZO] = Coef.IntegralKp;
+   LimiteSuperior[LAZO] = CONFIG->LimiteSuperior;
+   LimiteInferior[LAZO] = CONFIG->LimiteInferior;
+   Derivar[LAZO]        = Mascara(CONFIG->Td != 0);
+   Integrar[LAZO]       = Mascara(CONFIG->Ti != 0);
+   Compensar[LAZO]      = Mascara(CONFIG->CompensarIntegral);
+   Limitar[LAZO]        = Mascara(LimitarSalida);
+
+   // Resetea valores de integración (aunque mantiene la integral)
+   Iniciado[LAZO]             = Mascara(false);
+   ErrorAnterior[LAZO]        = 0;
+   CompensacionAnterior[LAZO] = 0;
+}
+
+template <unsigned int N>
+void controlPIDBanco<N>::Objetivo(unsigned int LAZO, float OBJETIVO)
+{
+   Objetivos[LAZO] = OBJETIVO;
+}
+
+template <unsigned int N>
+void controlPIDBanco<N>::Apagar(unsigned int LAZO)
+{
+   Iniciado[LAZO]             = Mascara(false);
+   ErrorAnterior[LAZO]        = 0;
+   CompensacionAnterior[LAZO] = 0;
+   Integral[LAZO]             = 0;
+   Derivativo[LAZO]           = 0;
+   Salida[LAZO]               = 0;
+   UltimaMedicion[LAZO]       = 0;
+}
+
+template <unsigned int N>
+void controlPIDBanco<N>::Leer(unsigned int LAZO, pid_info_s * INFO)
+{
+   INFO->Salida                 = Salida[LAZO];
+   INFO->ComponenteProporcional = Kp[LAZO] * ErrorAnterior[LAZO];
+   INFO->ComponenteIntegral     = Integral[LAZO];
+   INFO->ComponenteDerivativo   = Derivativo[LAZO];
+   INFO->Compensacion           = CompensacionAnterior[LAZO];
+   INFO->UltimaMedicion         = UltimaMedicion[LAZO];
+   INFO->LimitarSalida          = Verdadero(Limitar[LAZO]);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+template <unsigned int N>
+void controlPIDBanco<N>::ControlarEscalar(unsigned int INICIO, unsigned int FIN,
+                                          const float * MEDICIONES, float * SALIDAS)
+// Mismas operaciones, en el mismo orden, que controlPID::Controlar() con período fijo.
+{
+   for (unsigned int i=INICIO; i<FIN; i++) {
+      bool  Anterior = Verdadero(Iniciado[i]);
+      float Error    = Objetivos[i] - MEDICIONES[i];
+      float P        = Kp[i] * Error;
+      float D        = 0;
+      float C        = 0;
+      if (Anterior && Verdadero(Derivar[i])) {
+         D = CoefDerivativo[i] * (Error-ErrorAnterior[i]);
+      }
+      float S = P + Integral[i] + D;
+      if (Verdadero(Compensar[i])) {
+         if (S > LimiteSuperior[i]) C = S - LimiteSuperior[i];
+         if (S < LimiteInferior[i]) C = S - LimiteInferior[i];
+      }
+      if (Anterior && Verdadero(Integrar[i])) {
+         float Incremento = CoefIntegralKp[i] * (Error+ErrorAnterior[i])
+                          - CoefIntegral[i] * (C+CompensacionAnterior[i]);
+         Integral[i] = Integral[i] + Incremento;
+         if (Verdadero(Limitar[i])) {
+            Integral[i] = min(Integral[i], LimiteSuperior[i]);
+            Integral[i] = max(Integral[i], LimiteInferior[i]);
+         }
+      }
+      S = P + Integral[i] + D;
+      if (Verdadero(Limitar[i])) {
+         S = min(S, LimiteSuperior[i]);
+         S = max(S, LimiteInferior[i]);
+      }
+      Derivativo[i]           = D;
+      Salida[i]               = S;
+      UltimaMedicion[i]       = MEDICIONES[i];
+      ErrorAnterior[i]        = Error;
+      CompensacionAnterior[i] = C;
+      Iniciado[i]             = Mascara(true);
+      SALIDAS[i]              = S;
+   }
+}
+
+template <unsigned int N>
+void controlPIDBanco<N>::Controlar(const float * MEDICIONES, float * SALIDAS)
+{
+#if PID_BANCO_ANCHO > 1
+   const unsigned int Vectorial = N / PID_BANCO_ANCHO * PID_BANCO_ANCHO;
+   const pid_vector_t Cero  = PID_Repetir(0);
+   const pid_vector_t Todos = PID_Repetir(Mascara(true));
+
+   for (unsigned int i=0; i<Vectorial; i+=PID_BANCO_ANCHO) {
+      pid_vector_t Medicion  = PID_CargarDesalineado(&MEDICIONES[i]);
+      pid_vector_t Anterior  = PID_Cargar(&Iniciado[i]);
+      pid_vector_t ErrorAnt  = PID_Cargar(&ErrorAnterior[i]);
+      pid_vector_t Sup       = PID_Cargar(&LimiteSuperior[i]);
+      pid_vector_t Inf       = PID_Cargar(&LimiteInferior[i]);
+      pid_vector_t Limita    = PID_Cargar(&Limitar[i]);
+      pid_vector_t I         = PID_Cargar(&Integral[i]);
+
+      pid_vector_t Error = PID_Restar(PID_Cargar(&Objetivos[i]), Medicion);
+      pid_vector_t P     = PID_Multiplicar(PID_Cargar(&Kp[i]), Error);
+      pid_vector_t D     = PID_Y( PID_Y(Anterior, PID_Cargar(&Derivar[i])),
+                                  PID_Multiplicar(PID_Cargar(&CoefDerivativo[i]),
+                                                  PID_Restar(Error, ErrorAnt)) );
+
+      // Compensación de enrole
+      pid_vector_t S = PID_Sumar(PID_Sumar(P, I), D);
+      pid_vector_t C = PID_Elegir(PID_Mayor(S, Sup), PID_Restar(S, Sup), Cero);
+      C = PID_Elegir(PID_Menor(S, Inf), PID_Restar(S, Inf), C);
+      C = PID_Y(PID_Cargar(&Compensar[i]), C);
+
+      // Integral
+      pid_vector_t Incremento = PID_Restar(
+         PID_Multiplicar(PID_Cargar(&CoefIntegralKp[i]), PID_Sumar(Error, ErrorAnt)),
+         PID_Multiplicar(PID_Cargar(&CoefIntegral[i]),
+                         PID_Sumar(C, PID_Cargar(&CompensacionAnterior[i]))) );
+      pid_vector_t INueva = PID_Sumar(I, Incremento);
+      INueva = PID_Elegir(Limita, PID_Maximo(PID_Minimo(INueva, Sup), Inf), INueva);
+      I = PID_Elegir(PID_Y(Anterior, PID_Cargar(&Integrar[i])), INueva, I);
+
+      // Salida
+      S = PID_Sumar(PID_Sumar(P, I), D);
+      S = PID_Elegir(Limita, PID_Maximo(PID_Minimo(S, Sup), Inf), S);
+
+      PID_Guardar(&Integral[i], I);
+      PID_Guardar(&Derivativo[i], D);
+      PID_Guardar(&Salida[i], S);
+      PID_Guardar(&UltimaMedicion[i], Medicion);
+      PID_Guardar(&ErrorAnterior[i], Error);
+      PID_Guardar(&CompensacionAnterior[i], C);
+      PID_Guardar(&Iniciado[i], Todos);
+      PID_GuardarDesalineado(&SALIDAS[i], S);
+   }
+   ControlarEscalar(Vectorial, N, MEDICIONES, SALIDAS);
+#else
+   ControlarEscalar(0, N, MEDICIONES, SALIDAS);
+#endif
+}
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_BANCO_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
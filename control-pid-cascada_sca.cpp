@@ -0,0 +1,224 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-cascada_sca.cpp
+* Versión:    3.0
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-cascada_sca.h"
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+grafoPID::grafoPID(unsigned long PERIODO)
+{
+   Periodo            = PERIODO;
+   CantidadLazos      = 0;
+   CantidadConexiones = 0;
+   Compilado          = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int8_t grafoPID::Agregar(controlPID * PID, float (*MEDIR)(), void (*ACTUAR)(float),
+                         uint8_t DIVISOR)
+{
+   if (CantidadLazos >= GRAFO_MAX_LAZOS) {
+      return GRAFO_LLENO;
+   }
+   lazo_s & L = Lazos[CantidadLazos];
+   L.PID     = PID;
+   L.Numero  = CantidadLazos;
+   L.Medir   = MEDIR;
+   L.Actuar  = ACTUAR;
+   L.Divisor = (DIVISOR > 0) ? DIVISOR : 1;
+   L.Cuenta  = 0;
+   if (Periodo > 0) {
+      PID->PeriodoFijo(Periodo * L.Divisor);
+   }
+   Compilado = false;
+   return CantidadLazos++;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool grafoPID::Consigna(uint8_t ORIGEN, uint8_t DESTINO, float GANANCIA)
+{
+   return ORIGEN < CantidadLazos && Conectar(GRAFO_CONSIGNA, ORIGEN, DESTINO, GANANCIA, 0);
+}
+
+bool grafoPID::Sumar(uint8_t ORIGEN, uint8_t DESTINO, float GANANCIA)
+{
+   return ORIGEN < CantidadLazos && Conectar(GRAFO_SUMA, ORIGEN, DESTINO, GANANCIA, 0);
+}
+
+bool grafoPID::Prealimentar(float (*SENAL)(), uint8_t DESTINO, float GANANCIA)
+{
+   return SENAL != 0 && Conectar(GRAFO_SUMA, -1, DESTINO, GANANCIA, SENAL);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool grafoPID::Compilar()
+// Orden topológico (Kahn): en cada paso toma el primer lazo, en orden de declaración, cuyos
+// orígenes ya fueron ubicados. Después copia los lazos en ese orden y agrupa las conexiones
+// por destino, para que Ejecutar() recorra sólo arreglos contiguos.
+{
+   uint8_t Pendientes[GRAFO_MAX_LAZOS];   // Orígenes de cada lazo aún sin ubicar
+   bool    Ubicado[GRAFO_MAX_LAZOS];
+
+   for (uint8_t i=0; i<CantidadLazos; i++) {
+      Pendientes[i] = 0;
+      Ubicado[i]    = false;
+   }
+   for (uint8_t c=0; c<CantidadConexiones; c++) {
+      if (Conexiones[c].Origen >= 0) Pendientes[Conexiones[c].Destino]++;
+   }
+   for (uint8_t k=0; k<CantidadLazos; k++) {
+      uint8_t i = 0;
+      while (i < CantidadLazos && (Ubicado[i] || Pendientes[i] > 0)) i++;
+      if (i == CantidadLazos) {
+         Compilado = false;
+         return false;                    // Ciclo: ningún lazo se puede evaluar primero
+      }
+      Ubicado[i]  = true;
+      Posicion[i] = k;
+      for (uint8_t c=0; c<CantidadConexiones; c++) {
+         if (Conexiones[c].Origen == int8_t(i)) Pendientes[Conexiones[c].Destino]--;
+      }
+   }
+
+   uint8_t Cantidad = 0;
+   for (uint8_t i=0; i<CantidadLazos; i++) {
+      lazo_s & L = Orden[Posicion[i]];
+      L = Lazos[i];
+      for (uint8_t Tipo=GRAFO_CONSIGNA; Tipo<=GRAFO_SUMA; Tipo++) {
+         uint8_t Primera = Cantidad;
+         for (uint8_t c=0; c<CantidadConexiones; c++) {
+            const conexion_s & C = Conexiones[c];
+            if (C.Destino != i || C.Tipo != Tipo) continue;
+            Entradas[Cantidad].Origen   = (C.Origen >= 0) ? int8_t(Posicion[C.Origen]) : -1;
+            Entradas[Cantidad].Ganancia = C.Ganancia;
+            Entradas[Cantidad].Senal    = C.Senal;
+            Cantidad++;
+         }
+         if (Tipo == GRAFO_CONSIGNA) {
+            L.PrimeraConsigna = Primera;
+            L.Consignas       = Cantidad - Primera;
+         } else {
+            L.PrimeraSuma = Primera;
+            L.Sumas       = Cantidad - Primera;
+         }
+      }
+      Salidas[Posicion[i]] = 0;
+   }
+   Compilado = true;
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void grafoPID::Ejecutar()
+// Un período base: cada lazo cuyo divisor vence mide, controla con el objetivo armado por sus
+// consignas y actúa con su salida más las sumas. Los lazos lentos mantienen su última salida.
+{
+   if (!Compilado && !Compilar()) {
+      return;
+   }
+   for (uint8_t k=0; k<CantidadLazos; k++) {
+      lazo_s & L = Orden[k];
+      if (L.Cuenta > 0) {
+         L.Cuenta--;
+      } else {
+         EjecutarLazo(k, L.Medir());
+      }
+   }
+}
+
+void grafoPID::Ejecutar(const float * MEDICIONES)
+// Sin llamadas a MEDIR: el único costo agregado a cada Controlar() es recorrer sus entradas.
+{
+   if (!Compilado && !Compilar()) {
+      return;
+   }
+   for (uint8_t k=0; k<CantidadLazos; k++) {
+      lazo_s & L = Orden[k];
+      if (L.Cuenta > 0) {
+         L.Cuenta--;
+      } else {
+         EjecutarLazo(k, MEDICIONES[L.Numero]);
+      }
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+float grafoPID::Salida(uint8_t LAZO)
+{
+   if (!Compilado || LAZO >= CantidadLazos) {
+      return 0;
+   }
+   return Salidas[Posicion[LAZO]];
+}
+
+/**************************************************************************************************
+* Funciones privadas
+**************************************************************************************************/
+
+bool grafoPID::Conectar(uint8_t TIPO, int8_t ORIGEN, uint8_t DESTINO, float GANANCIA,
+                        float (*SENAL)())
+{
+   if (CantidadConexiones >= GRAFO_MAX_CONEXIONES || DESTINO >= CantidadLazos) {
+      return false;
+   }
+   conexion_s & C = Conexiones[CantidadConexiones++];
+   C.Tipo     = TIPO;
+   C.Origen   = ORIGEN;
+   C.Destino  = DESTINO;
+   C.Ganancia = GANANCIA;
+   C.Senal    = SENAL;
+   Compilado  = false;
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+inline void grafoPID::EjecutarLazo(uint8_t POSICION, float MEDICION)
+{
+   lazo_s & L = Orden[POSICION];
+   float Salida;
+   if (L.Divisor > 1) {
+      L.Cuenta = L.Divisor - 1;
+   }
+   if (L.Consignas > 0) {
+      Salida = L.PID->Controlar(MEDICION, SumarEntradas(L.PrimeraConsigna, L.Consignas));
+   } else {
+      Salida = L.PID->Controlar(MEDICION);
+   }
+   if (L.Sumas > 0) {
+      Salida = Salida + SumarEntradas(L.PrimeraSuma, L.Sumas);
+   }
+   Salidas[POSICION] = Salida;
+   if (L.Actuar) {
+      L.Actuar(Salida);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+float grafoPID::SumarEntradas(uint8_t PRIMERA, uint8_t CANTIDAD)
+{
+   float Suma = 0;
+   for (uint8_t e=PRIMERA; e<PRIMERA+CANTIDAD; e++) {
+      const entrada_s & E = Entradas[e];
+      Suma = Suma + E.Ganancia * ( (E.Origen >= 0) ? Salidas[E.Origen] : E.Senal() );
+   }
+   return Suma;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO control-pid-cascada_sca.cpp
+**************************************************************************************************/
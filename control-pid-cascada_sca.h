@@ -0,0 +1,106 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-cascada_sca.h
+* Breve:      Grafo de lazos encadenados: control en cascada (la salida de un lazo externo es el
+*             objetivo de uno interno), sumas de prealimentación (feed-forward) y divisores de
+*             ritmo entre lazos lentos y rápidos.
+*             Se declaran los lazos y sus conexiones; Compilar() los ordena topológicamente y
+*             arma, en arreglos contiguos, la lista de evaluación y las entradas de cada lazo.
+*             Ejecutar() recorre esa lista una vez por período base, sin búsquedas.
+*             Ejemplo (temperatura externa cada 10 períodos, corriente interna cada período):
+*                grafoPID Grafo(1000);
+*                uint8_t  Temp  = Grafo.Agregar(&PIDTemp, medirTemp, 0, 10);
+*                uint8_t  Corr  = Grafo.Agregar(&PIDCorr, medirCorr, actuar, 1);
+*                Grafo.Consigna(Temp, Corr, 1);
+*                ...  Grafo.Ejecutar();  // cada 1 ms
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_CASCADA_SCA_H
+#define CONTROL_PID_CASCADA_SCA_H
+
+#include "control-pid_sca.h"
+
+#ifndef GRAFO_MAX_LAZOS
+#define GRAFO_MAX_LAZOS      8            // Capacidad (se puede definir antes de incluir)
+#endif
+#ifndef GRAFO_MAX_CONEXIONES
+#define GRAFO_MAX_CONEXIONES 16
+#endif
+
+#define GRAFO_LLENO          -1           // Agregar() no tiene lugar para otro lazo
+
+#define GRAFO_CONSIGNA       0            // Origen * Ganancia se suma al objetivo del destino
+#define GRAFO_SUMA           1            // Origen * Ganancia se suma a la salida del destino
+
+class grafoPID                            // Clase para ejecutar lazos conectados entre sí
+{
+   private:
+   struct lazo_s {
+      controlPID *  PID;
+      uint8_t       Numero;               // Número devuelto por Agregar()
+      float       (*Medir)();             // Medición del lazo (0: Ejecutar(MEDICIONES))
+      void        (*Actuar)(float SALIDA);// Recibe la salida con las sumas (0: no actúa)
+      uint8_t       Divisor;              // Se ejecuta uno de cada Divisor períodos
+      uint8_t       Cuenta;               // Períodos hasta la próxima ejecución
+      uint8_t       PrimeraConsigna;      // Rango en Entradas[] de las consignas...
+      uint8_t       Consignas;
+      uint8_t       PrimeraSuma;          // ... y de las sumas
+      uint8_t       Sumas;
+   };
+   struct conexion_s {
+      uint8_t       Tipo;                 // GRAFO_CONSIGNA o GRAFO_SUMA
+      int8_t        Origen;               // Lazo de origen (-1: Senal)
+      uint8_t       Destino;
+      float         Ganancia;
+      float       (*Senal)();             // Señal externa (prealimentación de una perturbación)
+   };
+   struct entrada_s {                     // Conexión compilada
+      int8_t        Origen;               // Posición del origen en Orden[] (-1: Senal)
+      float         Ganancia;
+      float       (*Senal)();
+   };
+
+   lazo_s        Lazos[GRAFO_MAX_LAZOS];  // Tal como se agregaron
+   conexion_s    Conexiones[GRAFO_MAX_CONEXIONES];
+   lazo_s        Orden[GRAFO_MAX_LAZOS];  // Compilado: en orden de evaluación
+   entrada_s     Entradas[GRAFO_MAX_CONEXIONES];
+   float         Salidas[GRAFO_MAX_LAZOS];// Última salida de cada lazo, por posición en Orden[]
+   uint8_t       Posicion[GRAFO_MAX_LAZOS];
+   uint8_t       CantidadLazos;
+   uint8_t       CantidadConexiones;
+   unsigned long Periodo;
+   bool          Compilado;
+
+   bool Conectar(uint8_t TIPO, int8_t ORIGEN, uint8_t DESTINO, float GANANCIA, float (*SENAL)());
+   float SumarEntradas(uint8_t PRIMERA, uint8_t CANTIDAD);
+   void  EjecutarLazo(uint8_t POSICION, float MEDICION);
+
+   public:
+   grafoPID(unsigned long PERIODO);       // Período base en microsegundos. Cada lazo queda en
+                                          // PeriodoFijo(PERIODO*DIVISOR) (0: miden el tiempo).
+   int8_t Agregar(controlPID * PID, float (*MEDIR)(), void (*ACTUAR)(float), uint8_t DIVISOR);
+                                          // Devuelve el número de lazo o GRAFO_LLENO.
+   bool Consigna(uint8_t ORIGEN, uint8_t DESTINO, float GANANCIA);
+                                          // Objetivo de DESTINO = suma de GANANCIA * salida de
+                                          // cada ORIGEN (cascada).
+   bool Sumar(uint8_t ORIGEN, uint8_t DESTINO, float GANANCIA);
+                                          // Suma GANANCIA * salida de ORIGEN a la salida de
+                                          // DESTINO (después de sus límites).
+   bool Prealimentar(float (*SENAL)(), uint8_t DESTINO, float GANANCIA);
+                                          // Suma GANANCIA * SENAL() a la salida de DESTINO.
+   bool Compilar();                       // Ordena los lazos; false si hay un ciclo.
+   void Ejecutar();                       // Un período base (compila si hace falta).
+   void Ejecutar(const float * MEDICIONES);
+                                          // Ídem, con las mediciones en un arreglo indexado por
+                                          // número de lazo en lugar de llamar a MEDIR.
+   float Salida(uint8_t LAZO);            // Última salida del lazo, con las sumas.
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_CASCADA_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
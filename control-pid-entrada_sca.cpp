@@ -0,0 +1,233 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-entrada_sca.cpp
+* Versión:    3.0
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-entrada_sca.h"
+
+#define MASCARA_INDICE (ENTRADA_CAPACIDAD-1)
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+entradaPID::entradaPID()
+{
+   Escritura      = 0;
+   Lectura        = 0;
+   Ganancia       = 1;
+   Desplazamiento = 0;
+   Procesadas     = 0;
+   Descartadas    = 0;
+   Promediar(1, 1);                       // Sin filtro: cada lectura es una medición
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool entradaPID::Promediar(uint8_t ORDEN, uint16_t DECIMACION, uint8_t BITS)
+// Los integradores y peines son enteros sin signo de 32 bits que pueden desbordar: la aritmética
+// módulo 2^32 da la salida exacta siempre que ésta entre en 32 bits.
+{
+   if (ORDEN < 1 || ORDEN > ENTRADA_ORDEN_MAXIMO || DECIMACION < 1 || BITS < 1 || BITS > 16) {
+      return false;
+   }
+   uint8_t BitsDecimacion = 0;
+   while ((1UL << BitsDecimacion) < DECIMACION) BitsDecimacion++;
+   if (BITS + ORDEN * BitsDecimacion > 32) {
+      return false;
+   }
+   Filtro     = ENTRADA_CIC;
+   Orden      = ORDEN;
+   Decimacion = DECIMACION;
+   Reiniciar();
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool entradaPID::Suavizar(uint8_t CORRIMIENTO, uint8_t BITS)
+// El estado tiene 30-BITS bits fraccionarios, así la diferencia con la lectura entra en 31 bits
+// con signo y el redondeo del corrimiento no deja un error apreciable en régimen.
+{
+   if (CORRIMIENTO > 15 || BITS < 1 || BITS > 16) {
+      return false;
+   }
+   Filtro      = ENTRADA_IIR;
+   Corrimiento = CORRIMIENTO;
+   Fraccion    = 30 - BITS;
+   Reiniciar();
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void entradaPID::Escalar(float GANANCIA, float DESPLAZAMIENTO)
+{
+   Ganancia       = GANANCIA;
+   Desplazamiento = DESPLAZAMIENTO;
+   CalcularFactor();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool entradaPID::Agregar(uint16_t LECTURA)
+// Productor. Escribe la lectura y recién después avanza Escritura (índices de un byte); la
+// barrera mantiene ese orden también para el compilador y en procesadores de varios núcleos.
+{
+   uint8_t Siguiente = (Escritura + 1) & MASCARA_INDICE;
+   if (Siguiente == Lectura) {
+      Descartadas++;
+      return false;
+   }
+   Lecturas[Escritura] = LECTURA;
+   __sync_synchronize();
+   Escritura = Siguiente;
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+uint8_t entradaPID::Procesar()
+// Consumidor. Recorre sólo las lecturas que había al entrar, así el tiempo queda acotado por
+// ENTRADA_CAPACIDAD aunque la interrupción siga agregando. Las lecturas se toman después de
+// leer Escritura y sus lugares se liberan al final, de una vez, después de una barrera.
+{
+   uint8_t Hasta    = Escritura;
+   uint8_t Indice   = Lectura;
+   uint8_t Cantidad = 0;
+   __sync_synchronize();
+   while (Indice != Hasta) {
+      uint16_t X = Lecturas[Indice];
+      Indice = (Indice + 1) & MASCARA_INDICE;
+      Cantidad++;
+
+      if (Filtro == ENTRADA_IIR) {
+         int32_t Entrada = int32_t(X) << Fraccion;
+         if (!Valido || Corrimiento == 0) {
+            Estado = Entrada;
+         } else {
+            Estado += (Entrada - Estado + (int32_t(1) << (Corrimiento-1))) >> Corrimiento;
+         }
+         Resultado = uint32_t(Estado);
+         Valido    = true;
+         Nueva     = true;
+         continue;
+      }
+
+      // CIC: un integrador por orden en cada lectura...
+      uint32_t V = X;
+      for (uint8_t j=0; j<Orden; j++) {
+         Integradores[j] += V;
+         V = Integradores[j];
+      }
+      Suma += X;
+      if (++Cuenta < Decimacion) {
+         continue;
+      }
+      // ... y un peine por orden en cada salida.
+      for (uint8_t j=0; j<Orden; j++) {
+         uint32_t Entrada = V;
+         V         = V - Peines[j];
+         Peines[j] = Entrada;
+      }
+      if (Salidas < Orden) {
+         Salidas++;
+      }
+      Resultado = (Salidas < Orden) ? Suma : V;
+      Suma      = 0;
+      Cuenta    = 0;
+      Valido    = true;
+      Nueva     = true;
+   }
+   __sync_synchronize();
+   Lectura     = Indice;
+   Procesadas += Cantidad;
+   return Cantidad;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+float entradaPID::Medicion()
+{
+   Procesar();
+   if (!Valido) {
+      return Desplazamiento;
+   }
+   float Escala = (Filtro == ENTRADA_CIC && Salidas < Orden) ? FactorBloque : Factor;
+   float Valor  = float(Resultado) * Escala + Desplazamiento;
+   Anterior  = Entregada ? Actual : Valor;
+   Actual    = Valor;
+   Entregada = true;
+   Nueva     = false;
+   return Actual;
+}
+
+float entradaPID::Variacion()
+{
+   return Actual - Anterior;
+}
+
+bool entradaPID::Disponible()
+{
+   Procesar();
+   return Nueva;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned long entradaPID::LecturasProcesadas()
+{
+   return Procesadas;
+}
+
+unsigned long entradaPID::Perdidas()
+{
+   return Descartadas;
+}
+
+/**************************************************************************************************
+* Funciones privadas
+**************************************************************************************************/
+
+void entradaPID::Reiniciar()
+// Descarta lo pendiente moviendo Lectura (del consumidor), sin tocar Escritura.
+{
+   Lectura = Escritura;
+   for (uint8_t j=0; j<ENTRADA_ORDEN_MAXIMO; j++) {
+      Integradores[j] = 0;
+      Peines[j]       = 0;
+   }
+   Cuenta    = 0;
+   Suma      = 0;
+   Salidas   = 0;
+   Resultado = 0;
+   Estado    = 0;
+   Valido    = false;
+   Nueva     = false;
+   Entregada = false;
+   Actual    = 0;
+   Anterior  = 0;
+   CalcularFactor();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void entradaPID::CalcularFactor()
+{
+   if (Filtro == ENTRADA_IIR) {
+      Factor = Ganancia / float(1UL << Fraccion);
+   } else {
+      float Escala = 1;
+      for (uint8_t j=0; j<Orden; j++) Escala *= Decimacion;
+      Factor = Ganancia / Escala;
+   }
+   FactorBloque = Ganancia / Decimacion;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO control-pid-entrada_sca.cpp
+**************************************************************************************************/
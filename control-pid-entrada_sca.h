@@ -0,0 +1,119 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-entrada_sca.h
+* Breve:      Etapa de entrada con sobremuestreo y decimación. Las lecturas crudas del ADC se
+*             guardan con Agregar() en un buffer circular (un productor, un consumidor, sin
+*             bloqueos: puede llamarse desde la interrupción del ADC o de un timer) a una
+*             frecuencia mucho mayor que la del lazo, y Medicion() las pasa por un filtro en
+*             punto fijo y devuelve una medición filtrada por período de control:
+*             - Promediar(ORDEN, DECIMACION): filtro CIC (integradores a la frecuencia de
+*               entrada, peines a la de salida). ORDEN 1 es el promedio de cada bloque de
+*               DECIMACION lecturas; ORDEN 2 y 3 atenúan más el ruido fuera de la banda útil.
+*             - Suavizar(CORRIMIENTO): pasabajos de primer orden y += (x - y) / 2^CORRIMIENTO en
+*               cada lectura; la salida se toma en cada Medicion().
+*             El costo por lectura es fijo (ORDEN sumas o una resta, un corrimiento y una suma),
+*             sin divisiones ni float; la escala a unidades (Escalar) se aplica una vez por
+*             medición. Con la medición filtrada, el derivativo de controlPID deja de amplificar
+*             el ruido del sensor; Variacion() da además la diferencia entre las dos últimas
+*             mediciones para un derivativo sobre la medición.
+*             Medicion() procesa a lo sumo ENTRADA_CAPACIDAD-1 lecturas: si en un período llegan
+*             más, hay que llamar a Procesar() desde loop() mientras se espera (lo que no entra
+*             se cuenta en Perdidas()).
+*             Ejemplo (ADC disparado por un timer a 6,4 kHz, lazo a 100 Hz):
+*                static entradaPID Entrada;
+*                ISR(ADC_vect) { Entrada.Agregar(ADC); }
+*                Entrada.Promediar(2, 64);
+*                Entrada.Escalar(5.0 / 1023, 0);                 // Volts
+*                Lazo.Controlar(Entrada.Medicion());             // Una vez por período
+*                Entrada.Procesar();                             // En loop(), fuera del lazo
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_ENTRADA_SCA_H
+#define CONTROL_PID_ENTRADA_SCA_H
+
+#include "Arduino.h"
+
+#ifndef ENTRADA_CAPACIDAD
+#define ENTRADA_CAPACIDAD 64              // Lecturas en el buffer (potencia de 2, hasta 128)
+#endif
+
+#define ENTRADA_ORDEN_MAXIMO 3            // Orden máximo del filtro CIC
+#define ENTRADA_BITS_ADC     10           // Resolución predeterminada de las lecturas
+
+#define ENTRADA_CIC          0            // Filtros
+#define ENTRADA_IIR          1
+
+class entradaPID                          // Clase para la etapa de entrada
+{
+   private:
+   uint16_t         Lecturas[ENTRADA_CAPACIDAD];
+   volatile uint8_t Escritura;            // Sólo la modifica Agregar()
+   volatile uint8_t Lectura;              // Sólo la modifican Procesar() y la configuración
+   uint8_t          Filtro;
+   uint8_t          Orden;
+   uint8_t          Corrimiento;          // IIR
+   uint8_t          Fraccion;             // Bits fraccionarios del estado del IIR
+   uint8_t          Salidas;              // Salidas del CIC desde la configuración (hasta Orden)
+   uint16_t         Decimacion;
+   uint16_t         Cuenta;               // Lecturas del bloque en curso
+   uint32_t         Integradores[ENTRADA_ORDEN_MAXIMO];
+   uint32_t         Peines[ENTRADA_ORDEN_MAXIMO];
+   uint32_t         Suma;                 // Suma del bloque en curso, para el arranque del CIC
+   uint32_t         Resultado;            // Última salida del filtro, en unidades del ADC
+                                          // (CIC: por DECIMACION^ORDEN; IIR: por 2^Fraccion)
+   int32_t          Estado;               // IIR
+   bool             Valido;               // Hay al menos una salida
+   bool             Nueva;                // Hubo una salida desde la última Medicion()
+   bool             Entregada;            // Medicion() ya entregó una salida
+   float            Ganancia;             // Unidades por unidad del ADC
+   float            Desplazamiento;
+   float            Factor;               // Ganancia / escala de Resultado
+   float            FactorBloque;         // Ganancia / Decimacion (arranque del CIC)
+   float            Actual;               // Última medición entregada
+   float            Anterior;             // La previa
+   unsigned long    Procesadas;
+   unsigned long    Descartadas;          // Lecturas perdidas por buffer lleno
+
+   void Reiniciar();
+   void CalcularFactor();
+
+   public:
+   entradaPID();
+   bool Promediar(uint8_t ORDEN, uint16_t DECIMACION, uint8_t BITS = ENTRADA_BITS_ADC);
+                                          // Filtro CIC de ORDEN 1 a ENTRADA_ORDEN_MAXIMO que
+                                          // entrega una salida cada DECIMACION lecturas de BITS
+                                          // bits. false si la salida no entra en 32 bits
+                                          // (BITS + ORDEN * log2(DECIMACION) > 32). Las primeras
+                                          // ORDEN-1 salidas son el promedio simple del bloque.
+   bool Suavizar(uint8_t CORRIMIENTO, uint8_t BITS = ENTRADA_BITS_ADC);
+                                          // Pasabajos de primer orden con constante de tiempo
+                                          // de unas 2^CORRIMIENTO lecturas (0 a 15). Arranca en
+                                          // la primera lectura.
+   void Escalar(float GANANCIA, float DESPLAZAMIENTO);
+                                          // Medición = lectura filtrada * GANANCIA +
+                                          // DESPLAZAMIENTO (predeterminado: 1 y 0).
+                                          // Promediar() y Suavizar() descartan las lecturas
+                                          // pendientes y reinician el filtro.
+   bool Agregar(uint16_t LECTURA);        // Guarda una lectura cruda (desde una interrupción).
+                                          // false si se descartó por buffer lleno.
+   uint8_t Procesar();                    // Pasa por el filtro las lecturas guardadas y devuelve
+                                          // cuántas. Se puede llamar desde loop() para repartir
+                                          // el trabajo; Medicion() también lo hace.
+   float Medicion();                      // Procesa y devuelve la última salida del filtro en
+                                          // unidades (Desplazamiento si todavía no hay).
+   float Variacion();                     // Medición entregada menos la previa: con objetivo
+                                          // constante, -(Error - ErrorAnterior).
+   bool Disponible();                     // Hay una salida del filtro que Medicion() no entregó.
+                                          // Con CIC, una cada DECIMACION lecturas.
+   unsigned long LecturasProcesadas();
+   unsigned long Perdidas();              // Lecturas descartadas por buffer lleno
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_ENTRADA_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
@@ -0,0 +1,307 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-fijo_sca.h
+* Breve:      Control PID con la estructura fijada al compilar: controlPIDFijo<ESTRUCTURA, PIN,
+*             PERIODO, SINTONIA>. Tiene el mismo algoritmo que controlPID y su interfaz básica
+*             (Configurar, Obtener, Controlar, ControlarEn, Reloj, TiempoActual, TiempoMuestra,
+*             SalidaManual, Apagar, Leer y el PWM), pero las decisiones que controlPID toma en
+*             cada Controlar() (¿deriva?, ¿integra?,
+*             ¿compensa?, ¿limita?, ¿escribe el PWM?, ¿período fijo?) son constantes, así que el
+*             compilador descarta el código que no se usa. Si además la sintonía (Kp, Ti, Td y
+*             límites) se da como parámetro, los coeficientes son constantes de compilación
+*             (constexpr) y el objeto sólo guarda el objetivo; el código no es necesariamente
+*             más chico: en x86-64, por ejemplo, cada constante es un operando de 32 bits de
+*             desplazamiento en lugar de uno de 8 bits respecto del objeto ("make -C host
+*             tamano" compara los tamaños).
+*             No tiene Reconfigurar() (cambiar la sintonía sin reiniciar), el modo por eventos
+*             (PID_EVENTOS) ni las estadísticas (PID_ESTADISTICAS), y no es un controlPID: no se
+*             puede pasar a planificadorPID, interrupcionPID, grabadorPID ni autoajustePID.
+*             Ejemplos:
+*                controlPIDFijo<PID_ESTRUCTURA_PI | PID_LIMITAR | PID_ANTIENROLE, 3, 500000> Lazo;
+*
+*                struct sintoniaHorno { static constexpr float Kp = 5, Ti = 4, Td = 0,
+*                                       LimiteSuperior = 20, LimiteInferior = 0; };
+*                controlPIDFijo<PID_ESTRUCTURA_PI | PID_LIMITAR, 3, 500000, sintoniaHorno> Horno;
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_FIJO_SCA_H
+#define CONTROL_PID_FIJO_SCA_H
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+
+// Estructura (se combinan con |):
+#define PID_INTEGRAL        0x01          // Término integral (con Ti=0 no integra igual)
+#define PID_DERIVATIVO      0x02          // Término derivativo (con Td=0 no deriva igual)
+#define PID_LIMITAR         0x04          // Limita salida e integral (los límites deben diferir)
+#define PID_ANTIENROLE      0x08          // CompensarIntegral (requiere PID_LIMITAR)
+
+#define PID_ESTRUCTURA_P    0
+#define PID_ESTRUCTURA_PI   PID_INTEGRAL
+#define PID_ESTRUCTURA_PD   PID_DERIVATIVO
+#define PID_ESTRUCTURA_PID  (PID_INTEGRAL | PID_DERIVATIVO)
+
+struct pid_sintonia_configurable {};      // SINTONIA predeterminada: se carga con Configurar()
+
+/**************************************************************************************************
+* Parámetros: constantes (SINTONIA) o cargados con Configurar() (pid_sintonia_configurable)
+**************************************************************************************************/
+
+template <class SINTONIA, unsigned long PERIODO>
+struct pid_parametros_t                   // Sintonía constante: sólo el objetivo es variable.
+{
+   float Objetivo;
+
+   void Cargar(const pid_config_s * CONFIG) { Objetivo = CONFIG->Objetivo; }
+   static float Kp()                      { return SINTONIA::Kp; }
+   static float Ti()                      { return SINTONIA::Ti; }
+   static float Td()                      { return SINTONIA::Td; }
+   static float LimiteSuperior()          { return SINTONIA::LimiteSuperior; }
+   static float LimiteInferior()          { return SINTONIA::LimiteInferior; }
+
+   // Mismas cuentas y en el mismo orden que CalcularCoeficientesPID(). Son constantes de
+   // compilación (constexpr), no una optimización opcional: ni divisiones ni lecturas de la
+   // configuración en Controlar().
+   static constexpr float CoeficienteDerivativo =
+      (PERIODO>0) ? SINTONIA::Kp * SINTONIA::Td * 1e6f / PERIODO : SINTONIA::Kp * SINTONIA::Td * 1e6f;
+   static constexpr float CoeficienteIntegral =
+      (SINTONIA::Ti==0) ? 0 : (PERIODO>0) ? 1 / (2*SINTONIA::Ti*1e6f) * PERIODO
+                                          : 1 / (2*SINTONIA::Ti*1e6f);
+   static constexpr float CoeficienteIntegralKp = SINTONIA::Kp * CoeficienteIntegral;
+   static float Derivativo()              { return CoeficienteDerivativo; }
+   static float Integral()                { return CoeficienteIntegral; }
+   static float IntegralKp()              { return CoeficienteIntegralKp; }
+};
+
+template <unsigned long PERIODO>
+struct pid_parametros_t<pid_sintonia_configurable, PERIODO>
+{
+   float              Objetivo;
+   pid_config_s       Configuracion;
+   pid_coeficientes_s Coeficientes;
+
+   void Cargar(const pid_config_s * CONFIG)
+   {
+      Configuracion = *CONFIG;
+      Objetivo      = CONFIG->Objetivo;
+      CalcularCoeficientesPID(CONFIG, PERIODO, &Coeficientes);
+   }
+   float Kp() const                       { return Configuracion.Kp; }
+   float Ti() const                       { return Configuracion.Ti; }
+   float Td() const                       { return Configuracion.Td; }
+   float LimiteSuperior() const           { return Configuracion.LimiteSuperior; }
+   float LimiteInferior() const           { return Configuracion.LimiteInferior; }
+   float Derivativo() const               { return Coeficientes.Derivativo; }
+   float Integral() const                 { return Coeficientes.Integral; }
+   float IntegralKp() const               { return Coeficientes.IntegralKp; }
+};
+
+/**************************************************************************************************
+* Controlador
+**************************************************************************************************/
+
+template <uint8_t ESTRUCTURA, uint8_t PIN = PID_SIN_SALIDA, unsigned long PERIODO = 0,
+          class SINTONIA = pid_sintonia_configurable>
+class controlPIDFijo
+{
+   private:
+   static const bool Integra  = (ESTRUCTURA & PID_INTEGRAL)   != 0;
+   static const bool Deriva   = (ESTRUCTURA & PID_DERIVATIVO) != 0;
+   static const bool Limita   = (ESTRUCTURA & PID_LIMITAR)    != 0;
+   static const bool Compensa = (ESTRUCTURA & PID_ANTIENROLE) != 0;
+
+   static_assert(!Compensa || Limita, "PID_ANTIENROLE requiere PID_LIMITAR");
+
+   pid_parametros_t<SINTONIA, PERIODO> Parametros;
+   salidaPWM     Etapa;                   // Escala y último valor del PWM
+   pid_info_s    Admin;                   // Variables de administración del control PID
+   unsigned long TiempoAnterior;          // Tiempo de la medición anterior
+   unsigned long (*LeerReloj)();          // Reloj sin período fijo (micros() predeterminado)
+   bool          MuestraAnterior;         // Hubo una muestra desde Configurar() o Apagar()
+   float         ErrorAnterior;
+   float         CompensacionAnterior;
+
+   float Limitar(float VALOR) const
+   {
+      VALOR = min(VALOR, Parametros.LimiteSuperior());
+      VALOR = max(VALOR, Parametros.LimiteInferior());
+      return VALOR;
+   }
+
+   void EscribirSalida()                  // Misma escala que controlPID
+   {
+      if (PIN>0 && Limita) {
+         Etapa.Escribir(Admin.Salida);
+      }
+   }
+
+   public:
+   controlPIDFijo()
+   {
+      Etapa.Iniciar(PIN);
+      LeerReloj = micros;
+      Admin = {};
+      Admin.LimitarSalida = Limita;
+      pid_config_s Inicial = {};
+      Inicial.Kp = 1;                     // Como controlPID (sin efecto si SINTONIA es fija)
+      Configurar(&Inicial);
+   }
+
+   void Configurar(pid_config_s * CONFIG) // Con SINTONIA fija sólo toma el objetivo. Devuelve en
+                                          // CONFIG la configuración vigente.
+   {
+      if (CONFIG->LimiteSuperior < CONFIG->LimiteInferior) {
+         float SW = CONFIG->LimiteSuperior;
+         CONFIG->LimiteSuperior = CONFIG->LimiteInferior;
+         CONFIG->LimiteInferior = SW;
+      }
+      Parametros.Cargar(CONFIG);
+      Obtener(CONFIG);
+      Etapa.Escalar(Parametros.LimiteInferior(), Parametros.LimiteSuperior());
+      TiempoAnterior       = 0;
+      MuestraAnterior      = false;
+      ErrorAnterior        = 0;
+      CompensacionAnterior = 0;
+      Etapa.Apagar();
+   }
+
+   void Obtener(pid_config_s * CONFIG)
+   {
+      CONFIG->Objetivo          = Parametros.Objetivo;
+      CONFIG->Kp                = Parametros.Kp();
+      CONFIG->Ti                = Integra ? Parametros.Ti() : 0;
+      CONFIG->Td                = Deriva  ? Parametros.Td() : 0;
+      CONFIG->LimiteSuperior    = Parametros.LimiteSuperior();
+      CONFIG->LimiteInferior    = Parametros.LimiteInferior();
+      CONFIG->CompensarIntegral = Compensa;
+   }
+
+   bool CompensarIntegral(bool)           { return Compensa; }  // Fijado por ESTRUCTURA
+   bool CompensarIntegral()               { return Compensa; }
+   unsigned long PeriodoFijo()            { return PERIODO; }   // Fijado por PERIODO
+   unsigned long TiempoMuestra()          { return TiempoAnterior; }
+   void Reloj(unsigned long (*RELOJ)())   { LeerReloj = (RELOJ != 0) ? RELOJ : micros; }
+   unsigned long TiempoActual()           { return LeerReloj(); }
+
+   float Controlar(float MEDICION, float OBJETIVO)
+   {
+      Parametros.Objetivo = OBJETIVO;
+      return Controlar(MEDICION);
+   }
+
+   float Controlar(float MEDICION)
+   {
+      return ControlarEn((PERIODO>0) ? TiempoAnterior + PERIODO : LeerReloj(), MEDICION);
+   }
+
+   float ControlarEn(unsigned long TIEMPO, float MEDICION, float OBJETIVO)
+   {
+      Parametros.Objetivo = OBJETIVO;
+      return ControlarEn(TIEMPO, MEDICION);
+   }
+
+   float ControlarEn(unsigned long TIEMPO, float MEDICION)
+                                          // Mismo cálculo que controlPID::ControlarEn(): con
+                                          // PERIODO fijo, TIEMPO sólo se registra.
+   {
+      float         Error        = Parametros.Objetivo - MEDICION;
+      bool          Primera      = !MuestraAnterior;
+
+      Admin.UltimaMedicion         = MEDICION;
+      Admin.ComponenteProporcional = Parametros.Kp() * Error;
+
+      if (Deriva) {
+         if (!Primera && Parametros.Td()!=0) {
+            Admin.ComponenteDerivativo = Parametros.Derivativo() * (Error-ErrorAnterior);
+            if (PERIODO==0) {
+               Admin.ComponenteDerivativo = Admin.ComponenteDerivativo
+                                          / (TIEMPO-TiempoAnterior);
+            }
+         } else {
+            Admin.ComponenteDerivativo = 0;
+         }
+      }
+
+      Admin.Compensacion = 0;
+      if (Compensa) {
+         Admin.Salida = Admin.ComponenteProporcional
+                      + Admin.ComponenteIntegral
+                      + Admin.ComponenteDerivativo;
+         if (Admin.Salida > Parametros.LimiteSuperior()) {
+            Admin.Compensacion = Admin.Salida - Parametros.LimiteSuperior();
+         }
+         if (Admin.Salida < Parametros.LimiteInferior()) {
+            Admin.Compensacion = Admin.Salida - Parametros.LimiteInferior();
+         }
+      }
+
+      if (Integra && !Primera && Parametros.Ti()!=0) {
+         float Incremento = Parametros.IntegralKp() * (Error+ErrorAnterior);
+         if (Compensa) {
+            Incremento = Incremento
+                       - Parametros.Integral() * (Admin.Compensacion+CompensacionAnterior);
+         }
+         if (PERIODO==0) {
+            Incremento = Incremento * ( TIEMPO-TiempoAnterior );
+         }
+         Admin.ComponenteIntegral = Admin.ComponenteIntegral + Incremento;
+         if (Limita) {
+            Admin.ComponenteIntegral = Limitar(Admin.ComponenteIntegral);
+         }
+      }
+
+      Admin.Salida = Admin.ComponenteProporcional
+                   + Admin.ComponenteIntegral
+                   + Admin.ComponenteDerivativo;
+      if (Limita) {
+         Admin.Salida = Limitar(Admin.Salida);
+      }
+      EscribirSalida();
+
+      TiempoAnterior       = TIEMPO;
+      MuestraAnterior      = true;
+      ErrorAnterior        = Error;
+      CompensacionAnterior = Admin.Compensacion;
+      return Admin.Salida;
+   }
+
+   float SalidaManual(float SALIDA)       // Ver controlPID::SalidaManual()
+   {
+      Admin.Salida = Limita ? Limitar(SALIDA) : SALIDA;
+      EscribirSalida();
+      return Admin.Salida;
+   }
+
+   void Apagar()
+   {
+      TiempoAnterior               = 0;
+      MuestraAnterior              = false;
+      ErrorAnterior                = 0;
+      CompensacionAnterior         = 0;
+      Admin.ComponenteIntegral     = 0;
+      Admin.ComponenteProporcional = 0;
+      Admin.ComponenteDerivativo   = 0;
+      Etapa.Apagar();
+   }
+
+   uint8_t ResolucionPWM(uint8_t BITS)    // Ver controlPID
+   {
+      return Etapa.Resolucion(BITS);
+   }
+   void RegistroPWM(volatile uint8_t * REGISTRO)  { Etapa.Registro(REGISTRO); }
+   void RegistroPWM(volatile uint16_t * REGISTRO) { Etapa.Registro(REGISTRO); }
+
+   void Leer(pid_info_s * INFO)
+   {
+      *INFO = Admin;
+   }
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_FIJO_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
@@ -0,0 +1,302 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-grabador_sca.cpp
+* Versión:    3.0 
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-grabador_sca.h"
+#include "control-pid-telemetria_sca.h"   // CRC16Telemetria()
+
+#include <string.h>
+
+#define MASCARA_INDICE (GRABADOR_CAPACIDAD-1)
+
+/**************************************************************************************************
+* Funciones de trama (usadas también por el reproductor de PC)
+**************************************************************************************************/
+
+uint8_t ArmarTramaTraza(const pid_evento_s * EVENTO, uint8_t * TRAMA)
+{
+   uint8_t * D = &TRAMA[4];
+   uint8_t   Largo = 0;
+   uint32_t  Entero;
+   
+   switch (EVENTO->Tipo) {
+      case TRAZA_MUESTRA:
+         Entero = EVENTO->Muestra.Tiempo;
+         memcpy(&D[0],  &Entero, 4);
+         memcpy(&D[4],  &EVENTO->Muestra.Medicion, 4);
+         memcpy(&D[8],  &EVENTO->Muestra.Objetivo, 4);
+         memcpy(&D[12], &EVENTO->Muestra.Salida, 4);
+         Largo = 16;
+         break;
+      case TRAZA_CONFIGURACION:
+      case TRAZA_RECONFIGURACION:
+         Entero = EVENTO->Configuracion.Periodo;
+         memcpy(&D[0],  &Entero, 4);
+         memcpy(&D[4],  &EVENTO->Configuracion.Config.Objetivo, 4);
+         memcpy(&D[8],  &EVENTO->Configuracion.Config.Kp, 4);
+         memcpy(&D[12], &EVENTO->Configuracion.Config.Ti, 4);
+         memcpy(&D[16], &EVENTO->Configuracion.Config.Td, 4);
+         memcpy(&D[20], &EVENTO->Configuracion.Config.LimiteSuperior, 4);
+         memcpy(&D[24], &EVENTO->Configuracion.Config.LimiteInferior, 4);
+         D[28] = EVENTO->Configuracion.Config.CompensarIntegral ? 1 : 0;
+         Largo = 29;
+         break;
+      case TRAZA_PERIODO:
+         Entero = EVENTO->Configuracion.Periodo;
+         memcpy(&D[0],  &Entero, 4);
+         Largo = 4;
+         break;
+      case TRAZA_EVENTOS:
+         Entero = EVENTO->Eventos.Silencio;
+         memcpy(&D[0],  &EVENTO->Eventos.Banda, 4);
+         memcpy(&D[4],  &Entero, 4);
+         Largo = 8;
+         break;
+      default:
+         break;
+   }
+   TRAMA[0] = TRAZA_SINCRONISMO_1;
+   TRAMA[1] = TRAZA_SINCRONISMO_2;
+   TRAMA[2] = EVENTO->Tipo;
+   TRAMA[3] = Largo;
+   uint16_t CRC = CRC16Telemetria(&TRAMA[2], Largo + 2);
+   TRAMA[4+Largo] = CRC & 0xFF;
+   TRAMA[5+Largo] = CRC >> 8;
+   return Largo + 6;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+uint8_t LeerTramaTraza(const uint8_t * TRAMA, unsigned long DISPONIBLE, pid_evento_s * EVENTO)
+{
+   const uint8_t * D = &TRAMA[4];
+   uint32_t Entero;
+   
+   if (DISPONIBLE < 6 || TRAMA[0] != TRAZA_SINCRONISMO_1 || TRAMA[1] != TRAZA_SINCRONISMO_2) {
+      return 0;
+   }
+   uint8_t Largo = TRAMA[3];
+   if (Largo + 6UL > DISPONIBLE || Largo + 6 > TRAZA_TRAMA_MAXIMA) {
+      return 0;
+   }
+   uint16_t CRC = TRAMA[4+Largo] | (uint16_t(TRAMA[5+Largo]) << 8);
+   if (CRC != CRC16Telemetria(&TRAMA[2], Largo + 2)) {
+      return 0;
+   }
+   EVENTO->Tipo = TRAMA[2];
+   switch (EVENTO->Tipo) {
+      case TRAZA_MUESTRA:
+         if (Largo != 16) return 0;
+         memcpy(&Entero, &D[0], 4);
+         EVENTO->Muestra.Tiempo = Entero;
+         memcpy(&EVENTO->Muestra.Medicion, &D[4],  4);
+         memcpy(&EVENTO->Muestra.Objetivo, &D[8],  4);
+         memcpy(&EVENTO->Muestra.Salida,   &D[12], 4);
+         break;
+      case TRAZA_CONFIGURACION:
+      case TRAZA_RECONFIGURACION:
+         if (Largo != 29) return 0;
+         memcpy(&Entero, &D[0], 4);
+         EVENTO->Configuracion.Periodo = Entero;
+         memcpy(&EVENTO->Configuracion.Config.Objetivo,       &D[4],  4);
+         memcpy(&EVENTO->Configuracion.Config.Kp,             &D[8],  4);
+         memcpy(&EVENTO->Configuracion.Config.Ti,             &D[12], 4);
+         memcpy(&EVENTO->Configuracion.Config.Td,             &D[16], 4);
+         memcpy(&EVENTO->Configuracion.Config.LimiteSuperior, &D[20], 4);
+         memcpy(&EVENTO->Configuracion.Config.LimiteInferior, &D[24], 4);
+         EVENTO->Configuracion.Config.CompensarIntegral = (D[28] != 0);
+         break;
+      case TRAZA_PERIODO:
+         if (Largo != 4) return 0;
+         memcpy(&Entero, &D[0], 4);
+         EVENTO->Configuracion.Periodo = Entero;
+         break;
+      case TRAZA_EVENTOS:
+         if (Largo != 8) return 0;
+         memcpy(&EVENTO->Eventos.Banda, &D[0], 4);
+         memcpy(&Entero, &D[4], 4);
+         EVENTO->Eventos.Silencio = Entero;
+         break;
+      case TRAZA_APAGADO:
+         if (Largo != 0) return 0;
+         break;
+      default:
+         return 0;
+   }
+   return Largo + 6;
+}
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+grabadorPID::grabadorPID(controlPID * PID_A_GRABAR)
+{
+   PID         = PID_A_GRABAR;
+   Escritura   = 0;
+   Lectura     = 0;
+   Largo       = 0;
+   Enviados    = 0;
+   Descartados = 0;
+   GuardarConfiguracion(TRAZA_CONFIGURACION);  // La traza empieza con la configuración vigente
+#if PID_EVENTOS
+   GuardarEventos();                           // y el modo por eventos
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void grabadorPID::Configurar(pid_config_s * CONFIG)
+{
+   PID->Configurar(CONFIG);
+   GuardarConfiguracion(TRAZA_CONFIGURACION);
+}
+
+void grabadorPID::Reconfigurar(const pid_config_s * CONFIG)
+// Graba la configuración pedida; el controlador la aplica en el próximo Controlar(), igual
+// que al reproducir.
+{
+   pid_evento_s Evento;
+   PID->Reconfigurar(CONFIG);
+   Evento.Tipo                  = TRAZA_RECONFIGURACION;
+   Evento.Configuracion.Config  = *CONFIG;
+   Evento.Configuracion.Periodo = PID->PeriodoFijo();
+   Objetivo = CONFIG->Objetivo;
+   Guardar(&Evento);
+}
+
+unsigned long grabadorPID::PeriodoFijo(unsigned long PERIODO)
+{
+   unsigned long Periodo = PID->PeriodoFijo(PERIODO);
+   GuardarConfiguracion(TRAZA_PERIODO);
+   return Periodo;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+float grabadorPID::Controlar(float MEDICION)
+{
+   return Controlar(MEDICION, Objetivo);
+}
+
+float grabadorPID::Controlar(float MEDICION, float OBJETIVO)
+{
+   pid_evento_s Evento;
+   Objetivo = OBJETIVO;
+   Evento.Tipo             = TRAZA_MUESTRA;
+   Evento.Muestra.Salida   = PID->Controlar(MEDICION, OBJETIVO);
+   Evento.Muestra.Tiempo   = PID->TiempoMuestra();
+   Evento.Muestra.Medicion = MEDICION;
+   Evento.Muestra.Objetivo = OBJETIVO;
+   Guardar(&Evento);
+   return Evento.Muestra.Salida;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void grabadorPID::Apagar()
+{
+   pid_evento_s Evento;
+   PID->Apagar();
+   Evento.Tipo = TRAZA_APAGADO;
+   Guardar(&Evento);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+#if PID_EVENTOS
+void grabadorPID::Eventos(float BANDA, unsigned long SILENCIO)
+{
+   PID->Eventos(BANDA, SILENCIO);
+   GuardarEventos();
+}
+#endif
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned int grabadorPID::Transmitir(Print & PUERTO)
+// Consumidor (ver telemetriaPID::Transmitir).
+{
+   unsigned int Total = 0;
+   for (;;) {
+      if (Enviados >= Largo) {
+         if (Lectura == Escritura) {
+            break;
+         }
+         __sync_synchronize();
+         Largo    = ArmarTramaTraza(&Cola[Lectura], Trama);
+         __sync_synchronize();
+         Lectura  = (Lectura + 1) & MASCARA_INDICE;
+         Enviados = 0;
+      }
+      int Lugar = PUERTO.availableForWrite();
+      if (Lugar <= 0) {
+         break;
+      }
+      uint8_t Cantidad = min(uint8_t(Largo - Enviados), uint8_t(min(Lugar, 255)));
+      Cantidad = PUERTO.write(&Trama[Enviados], Cantidad);
+      if (Cantidad == 0) {
+         break;
+      }
+      Enviados += Cantidad;
+      Total    += Cantidad;
+   }
+   return Total;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned long grabadorPID::Perdidos()
+{
+   return Descartados;
+}
+
+/**************************************************************************************************
+* Funciones privadas
+**************************************************************************************************/
+
+void grabadorPID::Guardar(const pid_evento_s * EVENTO)
+// Productor del buffer circular (ver telemetriaPID::Registrar).
+{
+   uint8_t Siguiente = (Escritura + 1) & MASCARA_INDICE;
+   if (Siguiente == Lectura) {
+      Descartados++;
+      return;
+   }
+   Cola[Escritura] = *EVENTO;
+   __sync_synchronize();
+   Escritura = Siguiente;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void grabadorPID::GuardarConfiguracion(uint8_t TIPO)
+{
+   pid_evento_s Evento;
+   Evento.Tipo = TIPO;
+   PID->Obtener(&Evento.Configuracion.Config);
+   Evento.Configuracion.Periodo = PID->PeriodoFijo();
+   Objetivo = Evento.Configuracion.Config.Objetivo;
+   Guardar(&Evento);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+#if PID_EVENTOS
+void grabadorPID::GuardarEventos()
+{
+   pid_evento_s Evento;
+   Evento.Tipo = TRAZA_EVENTOS;
+   PID->ObtenerEventos(&Evento.Eventos.Banda, &Evento.Eventos.Silencio);
+   Guardar(&Evento);
+}
+#endif
+
+/**************************************************************************************************
+* FIN DE ARCHIVO control-pid-grabador_sca.cpp
+**************************************************************************************************/
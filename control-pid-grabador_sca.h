@@ -0,0 +1,122 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-grabador_sca.h
+* Breve:      Grabación de la ejecución de un controlPID para reproducirla después en la PC.
+*             grabadorPID se usa en lugar de llamar directamente al controlPID: registra cada
+*             muestra (tiempo usado por Controlar, MEDICION, OBJETIVO y Salida), cada cambio de
+*             configuración o período y cada Apagar(), y los envía por el puerto serie sin
+*             esperar, igual que telemetriaPID. host/reproducir_traza vuelve a ejecutar la traza
+*             con controlPID y compara las salidas.
+*             La traza empieza con la configuración vigente y su período fijo y, con PID_EVENTOS,
+*             con la banda y el silencio del modo por eventos, así que las muestras omitidas se
+*             reproducen igual (host/reproducir_eventos, compilado con PID_EVENTOS; el
+*             reproductor sin PID_EVENTOS avisa y falla si la banda no es 0). El reloj (Reloj())
+*             no se graba porque no hace falta: cada muestra lleva el tiempo que usó el
+*             controlador. Sólo se graba lo que pasa por grabadorPID: un PeriodoFijo() o un
+*             Eventos() hechos directamente en el controlPID no quedan en la traza.
+* Trama:      0xA5 0xC3 | tipo (1) | largo (1) | datos (largo) | CRC-16/CCITT de tipo a datos (2).
+*             Muestra:       tiempo (4), medición, objetivo, salida (3 x 4 float).
+*             Configuración: período fijo (4), Objetivo, Kp, Ti, Td, LimiteSuperior,
+*                            LimiteInferior (6 x 4 float), CompensarIntegral (1).
+*             Reconfiguración: como Configuración, pedida con Reconfigurar().
+*             Período:       período fijo (4), cambiado con PeriodoFijo().
+*             Eventos:       banda (4 float), silencio (4), de Eventos().
+*             Apagado:       sin datos.
+*             Enteros y float en little-endian.
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_GRABADOR_SCA_H
+#define CONTROL_PID_GRABADOR_SCA_H
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+
+#ifndef GRABADOR_CAPACIDAD
+#define GRABADOR_CAPACIDAD 8              // Eventos en el buffer (potencia de 2, hasta 128)
+#endif
+
+#define TRAZA_SINCRONISMO_1   0xA5
+#define TRAZA_SINCRONISMO_2   0xC3
+#define TRAZA_MUESTRA         1
+#define TRAZA_CONFIGURACION   2
+#define TRAZA_APAGADO         3
+#define TRAZA_PERIODO         4
+#define TRAZA_RECONFIGURACION 5
+#define TRAZA_EVENTOS         6
+#define TRAZA_TRAMA_MAXIMA    (4 + 29 + 2)
+
+struct pid_evento_s {
+   uint8_t Tipo;                          // TRAZA_MUESTRA, TRAZA_CONFIGURACION, TRAZA_PERIODO,
+                                          // TRAZA_APAGADO, TRAZA_RECONFIGURACION o
+                                          // TRAZA_EVENTOS
+   union {
+      struct {
+         unsigned long Tiempo;            // TiempoMuestra() del controlador
+         float         Medicion;
+         float         Objetivo;
+         float         Salida;
+      } Muestra;
+      struct {
+         unsigned long Periodo;           // PeriodoFijo() (0: tiempo medido)
+         pid_config_s  Config;
+      } Configuracion;                    // TRAZA_CONFIGURACION, TRAZA_RECONFIGURACION y
+                                          // TRAZA_PERIODO (sólo Periodo)
+      struct {
+         float         Banda;             // 0: evalúa todas las muestras
+         unsigned long Silencio;
+      } Eventos;
+   };
+};
+
+uint8_t ArmarTramaTraza(const pid_evento_s * EVENTO, uint8_t * TRAMA);
+                                          // Devuelve el largo de la trama (hasta 
+                                          // TRAZA_TRAMA_MAXIMA bytes).
+uint8_t LeerTramaTraza(const uint8_t * TRAMA, unsigned long DISPONIBLE, pid_evento_s * EVENTO);
+                                          // Decodifica la trama al comienzo de TRAMA. Devuelve
+                                          // su largo, o 0 si no es válida o está incompleta.
+
+class grabadorPID                         // Clase para grabar la ejecución de un controlPID
+{
+   private:
+   controlPID *     PID;
+   float            Objetivo;             // Objetivo vigente (para Controlar(MEDICION))
+   pid_evento_s     Cola[GRABADOR_CAPACIDAD];
+   volatile uint8_t Escritura;            // Sólo la modifica Guardar()
+   volatile uint8_t Lectura;              // Sólo la modifica Transmitir()
+   uint8_t          Trama[TRAZA_TRAMA_MAXIMA];
+   uint8_t          Largo;                // Largo de la trama en curso
+   uint8_t          Enviados;             // Bytes de Trama ya enviados
+   unsigned long    Descartados;
+   
+   void Guardar(const pid_evento_s * EVENTO);
+   void GuardarConfiguracion(uint8_t TIPO);
+#if PID_EVENTOS
+   void GuardarEventos();
+#endif
+
+   public:
+   grabadorPID(controlPID * PID_A_GRABAR);
+   void Configurar(pid_config_s * CONFIG);// Igual que en controlPID, y graba el cambio.
+   void Reconfigurar(const pid_config_s * CONFIG);
+   unsigned long PeriodoFijo(unsigned long PERIODO);
+   float Controlar(float MEDICION);       // Igual que en controlPID, y graba la muestra.
+   float Controlar(float MEDICION, float OBJETIVO);
+   void Apagar();
+#if PID_EVENTOS
+   void Eventos(float BANDA, unsigned long SILENCIO);
+#endif
+   unsigned int Transmitir(Print & PUERTO);
+                                          // Envía la traza pendiente sin esperar (ver 
+                                          // telemetriaPID::Transmitir).
+   unsigned long Perdidos();              // Eventos descartados por buffer lleno. Si no es 0,
+                                          // la traza no se puede reproducir exactamente.
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_GRABADOR_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
@@ -0,0 +1,158 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-interrupcion_sca.cpp
+* Versión:    3.0
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-interrupcion_sca.h"
+
+#include <string.h>
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+interrupcionPID::interrupcionPID(controlPID * PID, float (*MEDIR)(), void (*ACTUAR)(float),
+                                 unsigned long PERIODO)
+{
+   this->PID = PID;
+   Medir     = MEDIR;
+   Actuar    = ACTUAR;
+   LeerReloj = micros;
+   Periodo   = PERIODO;
+   Activo    = false;
+   EnCurso   = false;
+   Secuencia = 0;
+   Inicio    = 0;
+   memset(&Info, 0, sizeof(Info));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void interrupcionPID::Reloj(unsigned long (*RELOJ)())
+{
+   LeerReloj = (RELOJ != 0) ? RELOJ : micros;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void interrupcionPID::Iniciar()
+// Los contadores se ponen en 0 antes de activar, así un tic que llegue en el medio no ve
+// valores a medio borrar. El tiempo de la muestra vuelve a empezar desde el primer tic, así que
+// el controlador se apaga: después de un Detener() su última muestra quedaría en el futuro y el
+// intervalo hasta la siguiente desbordaría.
+{
+   Activo = false;
+   __sync_synchronize();
+   PID->Apagar();
+   Secuencia = Secuencia + 1;
+   memset(&Info, 0, sizeof(Info));
+   Inicio = LeerReloj();
+   Secuencia = Secuencia + 1;
+   __sync_synchronize();
+   Activo = true;
+}
+
+void interrupcionPID::Detener()
+{
+   Activo = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void interrupcionPID::Tic()
+// Productor. El tiempo de la muestra es el ideal del tic: la latencia de la interrupción no
+// entra en el cálculo, sólo en las estadísticas. Un tic que llega con el anterior en curso (lo
+// que en AVR no ocurre, porque las interrupciones no se anidan) se cuenta y se omite.
+{
+   unsigned long Entrada = LeerReloj();
+   if (!Activo) {
+      return;
+   }
+   if (EnCurso) {
+      Secuencia = Secuencia + 1;
+      Info.Tics++;
+      Info.Desbordes++;
+      Secuencia = Secuencia + 1;
+      return;
+   }
+   EnCurso = true;
+
+   unsigned long Tic    = Info.Tics + 1;
+   unsigned long Ideal  = Inicio + Tic * Periodo;
+   long          Atraso = long(Entrada - Ideal);
+   float         Salida = PID->ControlarEn(Tic * Periodo, Medir());
+   if (Actuar != 0) {
+      Actuar(Salida);
+   }
+
+   Secuencia = Secuencia + 1;
+   __sync_synchronize();
+   Info.Tics           = Tic;
+   Info.Ejecuciones++;
+   Info.LatenciaUltima = (Atraso > 0) ? Atraso : 0;
+   Info.LatenciaMaxima = max(Info.LatenciaMaxima, Info.LatenciaUltima);
+   PID->Leer(&Info.Lazo);
+   Info.DuracionUltima = LeerReloj() - Entrada;
+   Info.DuracionMaxima = max(Info.DuracionMaxima, Info.DuracionUltima);
+   __sync_synchronize();
+   Secuencia = Secuencia + 1;
+   EnCurso = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void interrupcionPID::Leer(pid_interrupcion_info_s * INFO)
+// Consumidor. Copia mientras la secuencia sea par y no cambie durante la copia.
+{
+   uint8_t Antes;
+   do {
+      Antes = Secuencia;
+      __sync_synchronize();
+      *INFO = Info;
+      __sync_synchronize();
+   } while ((Antes & 1) || Secuencia != Antes);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned long interrupcionPID::PeriodoTic()
+{
+   return Periodo;
+}
+
+/**************************************************************************************************
+* Timer1 de AVR
+**************************************************************************************************/
+
+#if defined(__AVR__) && defined(TCCR1B)
+
+bool ConfigurarTimer1(unsigned long PERIODO)
+{
+   static const uint16_t Divisores[] = { 1, 8, 64, 256, 1024 };
+   for (uint8_t i=0; i<5; i++) {
+      unsigned long Cuentas = (F_CPU / 1000000UL) * PERIODO / Divisores[i];
+      if (Cuentas >= 1 && Cuentas <= 65536UL) {
+         uint8_t Estado = SREG;
+         cli();
+         TCCR1A = 0;
+         TCCR1B = 0;
+         TCNT1  = 0;
+         OCR1A  = Cuentas - 1;
+         TCCR1B = _BV(WGM12) | (i + 1);     // CTC con OCR1A; CS12:0 = i+1 elige el divisor
+         TIMSK1 |= _BV(OCIE1A);
+         SREG = Estado;
+         return true;
+      }
+   }
+   return false;
+}
+
+#endif
+
+/**************************************************************************************************
+* FIN DE ARCHIVO control-pid-interrupcion_sca.cpp
+**************************************************************************************************/
@@ -0,0 +1,84 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-interrupcion_sca.h
+* Breve:      Ejecución de un controlPID desde la interrupción de un timer. Tic() se llama en
+*             cada interrupción y hace, siempre en el mismo orden, la lectura de la medición,
+*             ControlarEn() con el tiempo ideal del tic (número de tic * período, sin leer el
+*             reloj) y la escritura de la salida, así que el período no depende de lo que haga
+*             loop(). El trabajo por tic no tiene lazos ni esperas: su duración máxima es la de
+*             Medir + Controlar + Actuar, y se registra la peor observada.
+*             Con el timer en marcha, el contexto principal sólo usa:
+*             - Leer(): copia del estado y las estadísticas publicada por Tic() con número de
+*               secuencia (se reintenta si Tic() la interrumpe; Tic() nunca espera).
+*             - PID->Reconfigurar(): cambio de configuración que Tic() toma en el próximo tic.
+*             En AVR, ConfigurarTimer1() programa el Timer1 en modo CTC con el período pedido:
+*                static interrupcionPID Lazo(&Horno, MedirHorno, 0, 10000);
+*                ISR(TIMER1_COMPA_vect) { Lazo.Tic(); }
+*                Lazo.Iniciar();
+*                ConfigurarTimer1(10000);
+*             En Linux, host/latencia_pid lo ejecuta desde una señal de un timer POSIX.
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_INTERRUPCION_SCA_H
+#define CONTROL_PID_INTERRUPCION_SCA_H
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+
+struct pid_interrupcion_info_s {
+   unsigned long Tics;                    // Interrupciones recibidas desde Iniciar()
+   unsigned long Ejecuciones;             // Tics en que se ejecutó el lazo
+   unsigned long Desbordes;               // Tics omitidos porque el anterior seguía en curso
+   unsigned long LatenciaUltima;          // Retraso de la entrada a Tic() respecto del tic
+   unsigned long LatenciaMaxima;          // ideal (Inicio + n * Periodo), en microsegundos
+   unsigned long DuracionUltima;          // Duración de Tic(), en microsegundos
+   unsigned long DuracionMaxima;          // Peor caso observado
+   pid_info_s    Lazo;                    // Estado del controlador al final del último tic
+};
+
+class interrupcionPID                     // Clase para ejecutar un lazo desde un timer
+{
+   private:
+   controlPID *             PID;
+   float                  (*Medir)();
+   void                   (*Actuar)(float SALIDA);
+   unsigned long          (*LeerReloj)();
+   unsigned long            Periodo;      // En microsegundos
+   unsigned long            Inicio;       // Tiempo del reloj en Iniciar()
+   volatile bool            Activo;
+   volatile bool            EnCurso;
+   volatile uint8_t         Secuencia;    // Impar mientras Tic() escribe Info
+   pid_interrupcion_info_s  Info;
+
+   public:
+   interrupcionPID(controlPID * PID, float (*MEDIR)(), void (*ACTUAR)(float),
+                   unsigned long PERIODO);
+                                          // PERIODO del timer en microsegundos. ACTUAR puede
+                                          // ser 0 si alcanza con el pin del controlador.
+   void Reloj(unsigned long (*RELOJ)());  // Reloj de las estadísticas (0: micros()).
+   void Iniciar();                        // Reinicia estadísticas y tics, apaga el PID (que
+                                          // vuelve a empezar como recién configurado) y toma
+                                          // el origen del reloj. Llamar al arrancar el timer.
+   void Detener();                        // Los tics siguientes no hacen nada.
+   void Tic();                            // Desde la interrupción del timer.
+   void Leer(pid_interrupcion_info_s * INFO);
+                                          // Desde el contexto principal, sin bloquear el tic.
+   unsigned long PeriodoTic();
+};
+
+#if defined(__AVR__) && defined(TCCR1B)
+bool ConfigurarTimer1(unsigned long PERIODO);
+                                          // Timer1 en CTC con interrupción cada PERIODO
+                                          // microsegundos (el divisor más fino que alcance).
+                                          // false si no entra en 16 bits. Usa los PWM de los
+                                          // pines del Timer1 (9 y 10 en un ATmega328).
+#endif
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_INTERRUPCION_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
@@ -0,0 +1,122 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-programado_sca.cpp
+* Versión:    3.0
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-programado_sca.h"
+
+static void CoeficientesPunto(const pid_ganancias_s * PUNTO, unsigned long PERIODO,
+                              pid_coeficientes_s * COEF)
+{
+   pid_config_s Config = {};
+   Config.Kp = PUNTO->Kp;
+   Config.Ti = PUNTO->Ti;
+   Config.Td = PUNTO->Td;
+   CalcularCoeficientesPID(&Config, PERIODO, COEF);
+}
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+controlPIDProgramado::controlPIDProgramado(uint8_t PIN_SALIDA) : controlPID(PIN_SALIDA)
+{
+   Tabla              = 0;
+   PeriodoNodos       = 0;
+   Puntos             = 0;
+   VariableExterna    = 0;
+   Grilla.Nodos       = Nodos;
+   Grilla.Variable    = 0;
+   Grilla.Minimo      = 0;
+   Grilla.InversoPaso = 0;
+   Grilla.Cantidad    = PID_PROGRAMA_NODOS;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool controlPIDProgramado::Programar(const pid_ganancias_s * TABLA, uint8_t PUNTOS,
+                                     uint8_t FUENTE)
+{
+   if (TABLA != 0) {
+      if (PUNTOS == 0) {
+         return false;
+      }
+      for (uint8_t p=1; p<PUNTOS; p++) {
+         if ( !(TABLA[p].Punto > TABLA[p-1].Punto) ) {
+            return false;
+         }
+      }
+   }
+   Tabla           = TABLA;
+   Puntos          = PUNTOS;
+   Grilla.Variable = (FUENTE==PID_PROGRAMA_EXTERNA) ? &VariableExterna : 0;
+   if (Tabla != 0) {
+      CalcularNodos(PeriodoFijo());
+      ProveedorCoeficientes(this);
+   } else {
+      ProveedorCoeficientes(0);
+   }
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPIDProgramado::Variable(float VARIABLE)
+{
+   VariableExterna = VARIABLE;
+}
+
+/**************************************************************************************************
+* Funciones privadas
+**************************************************************************************************/
+
+void controlPIDProgramado::Calcular(const pid_config_s *, unsigned long PERIODO)
+// La grilla sólo depende de la tabla y del período: un Reconfigurar() del objetivo o de los
+// límites no la recalcula.
+{
+   if (PERIODO != PeriodoNodos) {
+      CalcularNodos(PERIODO);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPIDProgramado::CalcularNodos(unsigned long PERIODO)
+// Cada nodo toma los coeficientes de la tabla interpolados linealmente entre los dos puntos
+// que lo rodean.
+{
+   const pid_ganancias_s * T        = Tabla;
+   uint8_t                 Cantidad = Puntos;
+   float                   Minimo   = T[0].Punto;
+   float                   Maximo   = T[Cantidad-1].Punto;
+
+   Grilla.Minimo      = Minimo;
+   Grilla.InversoPaso = (Cantidad > 1) ? (PID_PROGRAMA_NODOS-1) / (Maximo-Minimo) : 0;
+   PeriodoNodos       = PERIODO;
+
+   uint8_t j = 0;
+   for (uint8_t n=0; n<PID_PROGRAMA_NODOS; n++) {
+      float X = Minimo + (Maximo-Minimo) * n / (PID_PROGRAMA_NODOS-1);
+      while (j+2 < Cantidad && T[j+1].Punto <= X) j++;
+      uint8_t k = (Cantidad > 1) ? j+1 : j;
+      float   Fraccion = 0;
+      if (k > j) {
+         Fraccion = (X - T[j].Punto) / (T[k].Punto - T[j].Punto);
+         Fraccion = max(min(Fraccion, 1.0f), 0.0f);
+      }
+      pid_coeficientes_s CA, CB;
+      CoeficientesPunto(&T[j], PERIODO, &CA);
+      CoeficientesPunto(&T[k], PERIODO, &CB);
+      Nodos[n].Kp         = T[j].Kp       + Fraccion * (T[k].Kp       - T[j].Kp);
+      Nodos[n].Derivativo = CA.Derivativo + Fraccion * (CB.Derivativo - CA.Derivativo);
+      Nodos[n].Integral   = CA.Integral   + Fraccion * (CB.Integral   - CA.Integral);
+   }
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO control-pid-programado_sca.cpp
+**************************************************************************************************/
@@ -0,0 +1,79 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-programado_sca.h
+* Breve:      Control PID con ganancias programadas (gain scheduling) para plantas no lineales.
+*             Se da una tabla de puntos de operación con su Kp, Ti y Td; Programar() la pasa a
+*             una grilla uniforme de PID_PROGRAMA_NODOS nodos con los coeficientes discretos ya
+*             calculados para el período, y cada Controlar() ubica la variable de programación
+*             (la medición o una variable externa) en la grilla con una resta y un producto e
+*             interpola linealmente los coeficientes entre los dos nodos vecinos.
+*             Es un controlPID que da su grilla como proveedorCoeficientesPID: el cálculo es el
+*             de controlPID::ControlarEn(), que interpola la grilla sin llamadas virtuales, con
+*             toda su interfaz (ControlarEn, Reloj, Reconfigurar, eventos, estadísticas) y se
+*             puede pasar a planificadorPID, interrupcionPID o autoajustePID.
+*             Se interpolan Kp, Kp*Td y 1/Ti (no Ti), así que un punto sin integral (Ti=0) no
+*             produce integrales enormes en los puntos vecinos. Fuera de la tabla se mantienen
+*             las ganancias del extremo.
+*             Ejemplo:
+*                static const pid_ganancias_s Tabla[] = { {  20, 8, 30, 0 },
+*                                                        { 100, 4, 12, 0 },
+*                                                        { 250, 2,  6, 0 } };
+*                controlPIDProgramado Horno(3);
+*                Horno.Programar(Tabla, 3, PID_PROGRAMA_MEDICION);
+*                Horno.Configurar(&Config);   // Objetivo, límites y compensación
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_PROGRAMADO_SCA_H
+#define CONTROL_PID_PROGRAMADO_SCA_H
+
+#include "control-pid_sca.h"
+
+#ifndef PID_PROGRAMA_NODOS
+#define PID_PROGRAMA_NODOS    17          // Nodos de la grilla uniforme (se puede definir antes
+#endif                                    // de incluir). Cada nodo ocupa 12 bytes.
+
+#define PID_PROGRAMA_MEDICION 0           // La variable de programación es la medición
+#define PID_PROGRAMA_EXTERNA  1           // La variable de programación se fija con Variable()
+
+struct pid_ganancias_s {
+   float Punto;               // Valor de la variable de programación (estrictamente creciente)
+   float Kp;
+   float Ti;                  // En segundos (0: no integra en ese punto)
+   float Td;                  // En segundos
+};
+
+class controlPIDProgramado : public controlPID, private proveedorCoeficientesPID
+{                                         // Clase para control PID con ganancias programadas
+   private:
+   static_assert(PID_PROGRAMA_NODOS >= 2, "PID_PROGRAMA_NODOS debe ser al menos 2");
+
+   const pid_ganancias_s * Tabla;         // 0: ganancias fijas de la configuración
+   uint8_t       Puntos;
+   pid_nodo_s    Nodos[PID_PROGRAMA_NODOS];
+   unsigned long PeriodoNodos;            // Período fijo con que se calculó la grilla
+   float         VariableExterna;
+   void CalcularNodos(unsigned long PERIODO);
+                                          // Grilla para la tabla y el PERIODO.
+   void Calcular(const pid_config_s * CONFIG, unsigned long PERIODO);
+
+   public:
+   controlPIDProgramado(uint8_t PIN_SALIDA);
+                                          // Como controlPID: PWM válido o PID_SIN_SALIDA.
+   bool Programar(const pid_ganancias_s * TABLA, uint8_t PUNTOS, uint8_t FUENTE);
+                                          // Carga la tabla de ganancias (debe seguir existiendo
+                                          // mientras se use). Devuelve false, sin cambiar nada,
+                                          // si está vacía o sus puntos no son crecientes. No
+                                          // reinicia el cálculo. TABLA = 0 vuelve a las
+                                          // ganancias fijas de Configurar(). Con tabla, Kp, Ti
+                                          // y Td de la configuración no se usan.
+   void Variable(float VARIABLE);         // Variable de programación con PID_PROGRAMA_EXTERNA.
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_PROGRAMADO_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
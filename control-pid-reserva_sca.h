@@ -0,0 +1,97 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-reserva_sca.h
+* Breve:      Reserva estática de controladores para placas con poca SRAM: N controlPID en un
+*             arreglo fijo (capacidad al compilar, sin memoria dinámica), que se toman con
+*             Crear() y se devuelven con Liberar(). El consumo total se conoce al compilar
+*             (N * sizeof(controlPID) + N/8 bytes) y aparece en el informe de memoria del IDE.
+*             Los controladores en uso se recorren por número con Lazo().
+*             Ejemplo:
+*                static reservaPID<4> Reserva;
+*                controlPID * Horno = Reserva.Crear(3);   // 0 si no queda lugar
+*                Horno->Configurar(&Config);
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_RESERVA_SCA_H
+#define CONTROL_PID_RESERVA_SCA_H
+
+#include "control-pid_sca.h"
+
+template <uint8_t N>
+class reservaPID                          // Controladores asignados estáticamente
+{
+   static_assert(N > 0 && N <= 127, "reservaPID admite de 1 a 127 controladores");
+
+   private:
+   controlPID Lazos[N];                   // Construidos sin pin; Crear() los reinicia
+   uint8_t    Ocupados[(N+7)/8];          // Un bit por controlador en uso
+   uint8_t    EnUso;
+
+   bool Ocupado(uint8_t I) const
+   {
+      return (Ocupados[I>>3] >> (I&7)) & 1;
+   }
+
+   public:
+   reservaPID()
+   {
+      for (uint8_t i=0; i<(N+7)/8; i++) Ocupados[i] = 0;
+      EnUso = 0;
+   }
+
+   controlPID * Crear(uint8_t PIN_SALIDA) // Toma el primer controlador libre y lo deja como
+   {                                      // recién construido con PIN_SALIDA. 0 si no hay.
+      for (uint8_t i=0; i<N; i++) {
+         if (!Ocupado(i)) {
+            Ocupados[i>>3] |= uint8_t(1 << (i&7));
+            EnUso++;
+            Lazos[i].Iniciar(PIN_SALIDA);
+            return &Lazos[i];
+         }
+      }
+      return 0;
+   }
+
+   bool Liberar(controlPID * PID)         // Apaga el controlador y lo devuelve a la reserva.
+   {                                      // false si no es de esta reserva o ya estaba libre.
+      int8_t i = Numero(PID);
+      if (i < 0) {
+         return false;
+      }
+      PID->Apagar();
+      Ocupados[i>>3] &= uint8_t(~(1 << (i&7)));
+      EnUso--;
+      return true;
+   }
+
+   int8_t Numero(const controlPID * PID) const
+                                          // Posición en la reserva de un controlador en uso
+   {                                      // (-1 si no pertenece o está libre).
+      if (PID < &Lazos[0] || PID >= &Lazos[N]) {
+         return -1;
+      }
+      uint8_t i = PID - &Lazos[0];
+      return Ocupado(i) ? int8_t(i) : -1;
+   }
+
+   controlPID * Lazo(uint8_t NUMERO)      // Controlador en uso en esa posición (0 si libre):
+   {                                      // for (i=0; i<reservaPID<N>::Capacidad; i++) ...
+      return (NUMERO < N && Ocupado(NUMERO)) ? &Lazos[NUMERO] : 0;
+   }
+
+   uint8_t Cantidad() const               // Controladores en uso
+   {
+      return EnUso;
+   }
+
+   static const uint8_t Capacidad = N;
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_RESERVA_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
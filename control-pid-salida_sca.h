@@ -0,0 +1,152 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-salida_sca.h
+* Breve:      Etapa de salida PWM de los controladores. La escala de la salida al ciclo de
+*             trabajo se calcula al configurar los límites (Escala y Desplazamiento, con el
+*             redondeo incluido), así que cada muestra cuesta un producto y una suma en lugar de
+*             una resta, una división y un producto. El valor se escribe sólo si cambió, con
+*             analogWrite() o directamente en el registro de comparación del timer.
+*             Resolución configurable de 1 a 16 bits (predeterminada PID_PWM_BITS: la de
+*             analogWrite() de AVR). Para más de 8 bits con analogWrite(), la placa debe admitir
+*             analogWriteResolution() con los mismos bits.
+*             Ejemplo (Timer1 de un ATmega328 en PWM rápido de 10 bits, pin 9):
+*                Lazo.ResolucionPWM(10);
+*                Lazo.RegistroPWM(&OCR1A);
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_SALIDA_SCA_H
+#define CONTROL_PID_SALIDA_SCA_H
+
+#include "Arduino.h"
+
+#ifndef PID_PWM_BITS
+#define PID_PWM_BITS 8                    // Resolución predeterminada (analogWrite de 0 a 255)
+#endif
+
+class salidaPWM                           // Escala y escritura del PWM de un controlador
+{
+   private:
+   uint8_t             Pin;               // 0: sin salida
+   uint8_t             Bits;
+   uint16_t            Maximo;            // (1<<Bits)-1: valor en el límite superior
+   uint16_t            Ultimo;            // Último valor escrito
+   bool                Activa;            // Hay pin y los límites difieren
+   float               Escala;            // Maximo / (Superior-Inferior)
+   float               Desplazamiento;    // 0.5 - Inferior*Escala (0.5 para redondear)
+   volatile uint8_t *  Registro8;         // Registro del timer (0: analogWrite)
+   volatile uint16_t * Registro16;
+
+   void Poner(uint16_t VALOR)
+   {
+      if (Registro16) {
+         *Registro16 = VALOR;
+      } else if (Registro8) {
+         *Registro8 = uint8_t(VALOR);
+      } else {
+         analogWrite(Pin, VALOR);
+      }
+   }
+
+   public:
+   void Iniciar(uint8_t PIN)              // Configura el pin y escribe 0.
+   {
+      Pin            = PIN;
+      Bits           = PID_PWM_BITS;
+      Maximo         = (1UL << Bits) - 1;
+      Activa         = false;
+      Escala         = 0;
+      Desplazamiento = 0;
+      Registro8      = 0;
+      Registro16     = 0;
+      if (Pin>0) {
+         pinMode(Pin, OUTPUT);
+      }
+      Apagar();
+   }
+
+   void Escalar(float INFERIOR, float SUPERIOR)
+                                          // INFERIOR corresponde a 0 y SUPERIOR a Maximo. Con
+                                          // límites iguales la salida no se escribe.
+   {
+      Activa = (Pin>0 && SUPERIOR != INFERIOR);
+      if (Activa) {
+         Escala         = Maximo / (SUPERIOR - INFERIOR);
+         Desplazamiento = 0.5f - INFERIOR * Escala;
+      }
+   }
+
+   uint8_t Resolucion(uint8_t BITS)       // Bits del PWM (1 a 16). Devuelve los aplicados.
+   {
+      BITS = min(max(BITS, uint8_t(1)), uint8_t(16));
+      uint16_t Nuevo = (1UL << BITS) - 1;
+      float    Razon = float(Nuevo) / Maximo;
+      Escala         = Escala * Razon;    // Misma cuenta que Escalar() con el nuevo Maximo
+      Desplazamiento = 0.5f + (Desplazamiento - 0.5f) * Razon;
+      Bits           = BITS;
+      Maximo         = Nuevo;
+      return Bits;
+   }
+
+   void Registro(volatile uint8_t * REGISTRO)
+                                          // Escribe directamente en un registro de 8 bits
+   {                                      // (p. ej. &OCR2A). 0: vuelve a analogWrite().
+      Registro8  = REGISTRO;
+      Registro16 = 0;
+      if (Pin>0) {
+         Poner(Ultimo);
+      }
+   }
+
+   void Registro(volatile uint16_t * REGISTRO)
+                                          // Ídem con un registro de 16 bits (p. ej. &OCR1A).
+   {
+      Registro8  = 0;
+      Registro16 = REGISTRO;
+      if (Pin>0) {
+         Poner(Ultimo);
+      }
+   }
+
+   bool Escribe()                         // Indica si Escribir() tiene efecto.
+   {
+      return Activa;
+   }
+
+   uint16_t ValorMaximo()
+   {
+      return Maximo;
+   }
+
+   void Escribir(float SALIDA)            // SALIDA debe estar entre los límites.
+   {
+      if (Activa) {
+         EscribirValor( uint16_t(SALIDA * Escala + Desplazamiento) );
+      }
+   }
+
+   void EscribirValor(uint16_t VALOR)     // Ciclo de trabajo ya escalado (0 a Maximo).
+   {
+      if (VALOR == Ultimo) {
+         return;                          // Sin cambios: no se toca el timer
+      }
+      Ultimo = VALOR;
+      Poner(VALOR);
+   }
+
+   void Apagar()                          // Escribe 0 aunque ya estuviera en 0.
+   {
+      Ultimo = 0;
+      if (Pin>0) {
+         Poner(0);
+      }
+   }
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_SALIDA_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
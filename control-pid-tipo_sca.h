@@ -0,0 +1,524 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    control-pid-tipo_sca.h
+* Breve:      Control PID parametrizado en el tipo numérico: controlPIDT<float>,
+*             controlPIDT<double> o controlPIDT<fijoQ16>.
+*             fijoQ16 es un número de punto fijo Q16.16 con saturación, pensado para placas sin
+*             unidad de punto flotante (AVR), donde las operaciones en float se emulan por software.
+*             El algoritmo es el mismo de controlPID (control-pid_sca.h): integral trapezoidal,
+*             compensación de enrole y derivada sobre el error.
+* Versión:    3.0.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef CONTROL_PID_TIPO_SCA_H
+#define CONTROL_PID_TIPO_SCA_H
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+
+/**************************************************************************************************
+* Punto fijo Q16.16 con saturación
+**************************************************************************************************/
+
+class fijoQ16                             // Número con 16 bits enteros y 16 fraccionarios
+{
+   public:
+   int32_t Valor;                         // Representación: número = Valor / 65536
+
+   static const int32_t MAXIMO = 0x7FFFFFFF;
+   static const int32_t MINIMO = -0x7FFFFFFF - 1;
+
+   fijoQ16()             : Valor(0) {}
+   fijoQ16(int ENTERO)   : Valor(Saturar( int64_t(ENTERO) * 65536 )) {}
+   fijoQ16(long ENTERO)  : Valor(Saturar( int64_t(ENTERO) * 65536 )) {}
+   fijoQ16(float REAL)   : Valor(DesdeReal(REAL)) {}
+   fijoQ16(double REAL)  : Valor(DesdeReal(REAL)) {}
+
+   static fijoQ16 Crudo(int32_t VALOR)    // Construye a partir de la representación interna
+   {
+      fijoQ16 R;
+      R.Valor = VALOR;
+      return R;
+   }
+   static int32_t Saturar(int64_t V)
+   {
+      if (V > MAXIMO) return MAXIMO;
+      if (V < MINIMO) return MINIMO;
+      return int32_t(V);
+   }
+   static int32_t DesdeReal(double REAL)
+   {
+      double V = REAL * 65536.0;
+      if (V >=  2147483647.0) return MAXIMO;
+      if (V <= -2147483648.0) return MINIMO;
+      return int32_t( V<0 ? V-0.5 : V+0.5 );
+   }
+
+   explicit operator float()  const { return Valor / 65536.0f; }
+   explicit operator double() const { return Valor / 65536.0; }
+   int Entero() const { return int(Valor >> 16); }   // Parte entera (redondeo hacia -infinito)
+
+   fijoQ16 operator-() const { return Crudo( Saturar( -int64_t(Valor) ) ); }
+   fijoQ16 operator+(fijoQ16 B) const { return Crudo( Saturar( int64_t(Valor) + B.Valor ) ); }
+   fijoQ16 operator-(fijoQ16 B) const { return Crudo( Saturar( int64_t(Valor) - B.Valor ) ); }
+   fijoQ16 operator*(fijoQ16 B) const
+   {
+      return Crudo( Saturar( ( int64_t(Valor) * B.Valor + 0x8000 ) >> 16 ) );
+   }
+   fijoQ16 operator/(fijoQ16 B) const
+   {
+      if (B.Valor==0) return Crudo( Valor<0 ? MINIMO : MAXIMO );
+      return Crudo( Saturar( ( int64_t(Valor) * 65536 ) / B.Valor ) );
+   }
+   fijoQ16 & operator+=(fijoQ16 B) { return *this = *this + B; }
+   fijoQ16 & operator-=(fijoQ16 B) { return *this = *this - B; }
+
+   bool operator< (fijoQ16 B) const { return Valor <  B.Valor; }
+   bool operator> (fijoQ16 B) const { return Valor >  B.Valor; }
+   bool operator<=(fijoQ16 B) const { return Valor <= B.Valor; }
+   bool operator>=(fijoQ16 B) const { return Valor >= B.Valor; }
+   bool operator==(fijoQ16 B) const { return Valor == B.Valor; }
+   bool operator!=(fijoQ16 B) const { return Valor != B.Valor; }
+};
+
+/**************************************************************************************************
+* Coeficientes discretos y escala del PWM.
+* Kp*Td y 1/(2*Ti), por microsegundo, se calculan en double al configurar. Los coeficientes de
+* la muestra (Kp*Td/DT y DT/(2*Ti)) se derivan de ellos cuando cambia el intervalo, y cada
+* muestra sólo los multiplica. En fijoQ16 el coeficiente se guarda como una mantisa de 32 bits
+* y un corrimiento, para no perder resolución con coeficientes chicos (DT/(2*Ti) suele ser del
+* orden de 1e-3): la muestra hace un producto de 32x32 bits y un corrimiento, y un intervalo
+* nuevo cuesta un producto de 32x32 bits y dos divisiones de 32 bits, sin double ni división de
+* 64 bits.
+**************************************************************************************************/
+
+template <typename T> struct pid_aritmetica_s {
+   typedef T Coeficiente;
+   static Coeficiente CrearCoeficiente(double C)
+   {
+      return T(C);
+   }
+   static T Multiplicar(T X, Coeficiente C)
+   {
+      return X * C;
+   }
+   static Coeficiente PorIntervalo(Coeficiente C, unsigned long DT)         // C*DT
+   {
+      return C * T(double(DT));
+   }
+   static Coeficiente SobreIntervalo(Coeficiente C, unsigned long DT)       // C/DT (DT>0)
+   {
+      return C / T(double(DT));
+   }
+   static uint16_t AEscala(T FRACCION, uint16_t MAXIMO)     // FRACCION (0 a 1) * MAXIMO
+   {
+      return uint16_t( FRACCION * T(double(MAXIMO)) + T(0.5) );
+   }
+};
+
+template <> struct pid_aritmetica_s<fijoQ16> {
+   struct Coeficiente {                   // Valor = Mantisa / 2^Corrimiento
+      int32_t Mantisa;
+      uint8_t Corrimiento;
+   };
+   static Coeficiente CrearCoeficiente(double C)
+   // La mantisa queda entre 2^30 y 2^31 (salvo coeficientes enormes, que se saturan, o
+   // diminutos, con corrimiento máximo 62). NaN vale 0.
+   {
+      Coeficiente R = { 0, 0 };
+      if (!(C == C) || C == 0) {
+         return R;
+      }
+      double M = C;
+      while (fabs(M) < 1073741824.0 && R.Corrimiento < 62) {
+         M = M * 2;
+         R.Corrimiento++;
+      }
+      if (M >=  2147483647.0) M =  2147483647.0;
+      if (M <= -2147483647.0) M = -2147483647.0;
+      R.Mantisa = int32_t( M<0 ? M-0.5 : M+0.5 );
+      return R;
+   }
+   static uint8_t Bits(uint32_t X)        // Bits significativos de X (instrucción CLZ)
+   {
+      return X ? uint8_t( 8*sizeof(unsigned long) - __builtin_clzl(X) ) : 0;
+   }
+   static uint32_t Intervalo(unsigned long DT)
+   {
+      return (DT > 0xFFFFFFFFUL) ? 0xFFFFFFFFUL : uint32_t(DT);
+   }
+   static Coeficiente Normalizar(uint64_t M, int16_t CORRIMIENTO, bool NEGATIVO)
+   // M/2^CORRIMIENTO (M < 2^63) con la mantisa entre 2^30 y 2^31, como CrearCoeficiente(),
+   // con un solo corrimiento.
+   {
+      Coeficiente R = { 0, 0 };
+      if (M == 0) {
+         return R;
+      }
+      uint8_t S = Bits( uint32_t(M >> 31) );
+      if (CORRIMIENTO - S > 62) {
+         S = CORRIMIENTO - 62;            // Diminuto: se pierden bits, como en CrearCoeficiente()
+      }
+      if (S > 0) {
+         M = ( M + (uint64_t(1) << (S-1)) ) >> S;
+         CORRIMIENTO -= S;
+         if (M >= 0x80000000ULL) {
+            M >>= 1;
+            CORRIMIENTO--;
+         }
+      }
+      if (M < 0x40000000ULL && CORRIMIENTO < 62) {
+         uint8_t L = 31 - Bits( uint32_t(M) );
+         if (CORRIMIENTO + L > 62) {
+            L = 62 - CORRIMIENTO;
+         }
+         M <<= L;
+         CORRIMIENTO += L;
+      }
+      if (CORRIMIENTO < 0 || M > 0x7FFFFFFFULL) {
+         M = 0x7FFFFFFF;                  // Enorme: se satura
+         CORRIMIENTO = 0;
+      }
+      R.Mantisa     = NEGATIVO ? -int32_t(M) : int32_t(M);
+      R.Corrimiento = uint8_t(CORRIMIENTO);
+      return R;
+   }
+   static Coeficiente PorIntervalo(Coeficiente C, unsigned long DT)
+   // Producto de 32x32 bits.
+   {
+      uint32_t M = uint32_t( C.Mantisa<0 ? -C.Mantisa : C.Mantisa );
+      return Normalizar( uint64_t(M) * Intervalo(DT), C.Corrimiento, C.Mantisa < 0 );
+   }
+   static Coeficiente SobreIntervalo(Coeficiente C, unsigned long DT)
+   // División larga con divisiones de 32 bits: el resto, corrido hasta llenar 32 bits, da K bits
+   // más de cociente. Con intervalos de hasta 16 s alcanzan dos divisiones.
+   {
+      uint32_t D           = Intervalo(DT);
+      uint32_t M           = uint32_t( C.Mantisa<0 ? -C.Mantisa : C.Mantisa );
+      uint8_t  K           = 32 - Bits(D);
+      uint64_t Cociente    = M / D;
+      uint32_t Resto       = M % D;
+      int16_t  Corrimiento = C.Corrimiento;
+      while (K > 0 && Cociente < 0x40000000ULL && Corrimiento < 62) {
+         uint32_t Parcial = Resto << K;
+         Cociente    = (Cociente << K) | (Parcial / D);
+         Resto       = Parcial % D;
+         Corrimiento = Corrimiento + K;
+      }
+      return Normalizar(Cociente, Corrimiento, C.Mantisa < 0);
+   }
+   static fijoQ16 Multiplicar(fijoQ16 X, Coeficiente C)
+   {
+      int64_t P = int64_t(X.Valor) * C.Mantisa;
+      if (C.Corrimiento > 0) {
+         P = ( P + (int64_t(1) << (C.Corrimiento-1)) ) >> C.Corrimiento;
+      }
+      return fijoQ16::Crudo( fijoQ16::Saturar(P) );
+   }
+   static uint16_t AEscala(fijoQ16 FRACCION, uint16_t MAXIMO)  // La inversa del rango en Q16
+   {                                                        // puede pasar apenas de 1
+      int32_t F = min(max(FRACCION.Valor, int32_t(0)), int32_t(65536));
+      return uint16_t( ( int64_t(F) * MAXIMO + 0x8000 ) >> 16 );
+   }
+};
+
+/**************************************************************************************************
+* Configuración e información en el tipo numérico T, y conversión desde/hacia las estructuras
+* en float de controlPID.
+**************************************************************************************************/
+
+template <typename T> struct pid_config_t {
+   T     Objetivo;
+   T     Kp;
+   T     Ti;
+   T     Td;
+   T     LimiteSuperior;
+   T     LimiteInferior;
+   bool  CompensarIntegral;
+};
+
+template <typename T> struct pid_info_t {
+   T     Salida;
+   T     ComponenteProporcional;
+   T     ComponenteIntegral;
+   T     ComponenteDerivativo;
+   T     Compensacion;
+   T     UltimaMedicion;
+   bool  LimitarSalida;
+};
+
+template <typename T> pid_config_t<T> ConvertirConfiguracion(const pid_config_s & C)
+{
+   pid_config_t<T> R;
+   R.Objetivo          = T(C.Objetivo);
+   R.Kp                = T(C.Kp);
+   R.Ti                = T(C.Ti);
+   R.Td                = T(C.Td);
+   R.LimiteSuperior    = T(C.LimiteSuperior);
+   R.LimiteInferior    = T(C.LimiteInferior);
+   R.CompensarIntegral = C.CompensarIntegral;
+   return R;
+}
+
+template <typename T> pid_config_s ConvertirConfiguracion(const pid_config_t<T> & C)
+{
+   pid_config_s R;
+   R.Objetivo          = float(C.Objetivo);
+   R.Kp                = float(C.Kp);
+   R.Ti                = float(C.Ti);
+   R.Td                = float(C.Td);
+   R.LimiteSuperior    = float(C.LimiteSuperior);
+   R.LimiteInferior    = float(C.LimiteInferior);
+   R.CompensarIntegral = C.CompensarIntegral;
+   return R;
+}
+
+template <typename T> pid_info_t<T> ConvertirInfo(const pid_info_s & I)
+{
+   pid_info_t<T> R;
+   R.Salida                 = T(I.Salida);
+   R.ComponenteProporcional = T(I.ComponenteProporcional);
+   R.ComponenteIntegral     = T(I.ComponenteIntegral);
+   R.ComponenteDerivativo   = T(I.ComponenteDerivativo);
+   R.Compensacion           = T(I.Compensacion);
+   R.UltimaMedicion         = T(I.UltimaMedicion);
+   R.LimitarSalida          = I.LimitarSalida;
+   return R;
+}
+
+template <typename T> pid_info_s ConvertirInfo(const pid_info_t<T> & I)
+{
+   pid_info_s R;
+   R.Salida                 = float(I.Salida);
+   R.ComponenteProporcional = float(I.ComponenteProporcional);
+   R.ComponenteIntegral     = float(I.ComponenteIntegral);
+   R.ComponenteDerivativo   = float(I.ComponenteDerivativo);
+   R.Compensacion           = float(I.Compensacion);
+   R.UltimaMedicion         = float(I.UltimaMedicion);
+   R.LimitarSalida          = I.LimitarSalida;
+   return R;
+}
+
+/**************************************************************************************************
+* Control PID en el tipo numérico T. Mismo uso que controlPID.
+**************************************************************************************************/
+
+template <typename T>
+class controlPIDT
+{
+   private:
+   typedef pid_aritmetica_s<T> A;
+   typedef typename A::Coeficiente Coeficiente;
+   pid_config_t<T> Configuracion;         // Parámetros configurados.
+   pid_info_t<T>   Admin;                 // Variables de administración del control PID
+   salidaPWM     Etapa;                   // Pin, resolución y último valor del PWM
+   bool          LimitarSalida;
+   unsigned long TiempoAnterior;          // Tiempo de la medición anterior (reloj o período)
+   unsigned long (*LeerReloj)();          // Reloj en microsegundos (micros() predeterminado)
+   bool          MuestraAnterior;         // Hubo una muestra desde Configurar() o Apagar()
+   T             ErrorAnterior;           // Señal de error anterior
+   T             CompensacionAnterior;
+   unsigned long PeriodoMuestreo;         // Período fijo en microsegundos (0: se mide)
+   unsigned long PeriodoCoeficientes;     // Intervalo con que se calcularon los coeficientes
+   Coeficiente   KpTd;                    // Kp*Td*MILLON (por microsegundo)
+   Coeficiente   InversaDosTi;            // 1/(2*Ti*MILLON) (0 si Ti=0)
+   Coeficiente   Derivativo;              // Kp*Td/DT
+   Coeficiente   Integral;                // DT/(2*Ti) (0 si Ti=0)
+   T             InversaRango;            // 1/(LimiteSuperior-LimiteInferior), para el PWM
+
+   public:
+   controlPIDT(uint8_t PIN_SALIDA)        // Constructor con PIN de salida (ver controlPID)
+   {
+      Etapa.Iniciar(PIN_SALIDA);
+      Admin = pid_info_t<T>();
+      PeriodoMuestreo = 0;
+      LeerReloj = micros;
+      pid_config_s Inicial = {};
+      Inicial.Kp = 1;
+      Configurar(&Inicial);
+   }
+
+   void Configurar(pid_config_s * CONFIG) // Configura todos los parámetros (corrige CONFIG)
+   {
+      if (CONFIG->LimiteSuperior < CONFIG->LimiteInferior) {
+         float SW = CONFIG->LimiteSuperior;
+         CONFIG->LimiteSuperior = CONFIG->LimiteInferior;
+         CONFIG->LimiteInferior = SW;
+      }
+      LimitarSalida = (CONFIG->LimiteSuperior != CONFIG->LimiteInferior);
+      CONFIG->CompensarIntegral = CONFIG->CompensarIntegral && LimitarSalida;
+      Configuracion = ConvertirConfiguracion<T>(*CONFIG);
+      Admin.LimitarSalida = LimitarSalida;
+
+      double Ti = double(Configuracion.Ti);
+      KpTd         = A::CrearCoeficiente( double(Configuracion.Kp) * double(Configuracion.Td) * 1e6 );
+      InversaDosTi = A::CrearCoeficiente( (Ti!=0) ? 1 / (2 * Ti * 1e6) : 0 );
+      CalcularCoeficientes(PeriodoMuestreo);
+      InversaRango = LimitarSalida ? T(1 / (CONFIG->LimiteSuperior - CONFIG->LimiteInferior))
+                                   : T(0);
+      Etapa.Escalar(CONFIG->LimiteInferior, CONFIG->LimiteSuperior);
+
+      TiempoAnterior       = 0;
+      MuestraAnterior      = false;
+      ErrorAnterior        = T(0);
+      CompensacionAnterior = T(0);
+      Etapa.Apagar();
+   }
+
+   void Obtener(pid_config_s * CONFIG)    // Obtiene los parámetros configurados.
+   {
+      *CONFIG = ConvertirConfiguracion(Configuracion);
+   }
+
+   unsigned long PeriodoFijo(unsigned long PERIODO)
+                                          // Ver controlPID. Con período fijo los coeficientes
+                                          // se calculan una vez; si no, cada vez que cambia el
+                                          // intervalo medido.
+   {
+      PeriodoMuestreo = PERIODO;
+      CalcularCoeficientes(PeriodoMuestreo);
+      return PeriodoMuestreo;
+   }
+   unsigned long PeriodoFijo() { return PeriodoMuestreo; }
+   unsigned long TiempoMuestra() { return TiempoAnterior; }
+   void Reloj(unsigned long (*RELOJ)()) { LeerReloj = (RELOJ != 0) ? RELOJ : micros; }
+   unsigned long TiempoActual() { return LeerReloj(); }
+
+   T Controlar(T MEDICION, T OBJETIVO)
+   {
+      Configuracion.Objetivo = OBJETIVO;
+      return Controlar(MEDICION);
+   }
+
+   T Controlar(T MEDICION)                // Calcula la señal de control (ver controlPID)
+   {
+      return ControlarEn((PeriodoMuestreo>0) ? TiempoAnterior + PeriodoMuestreo : LeerReloj(),
+                         MEDICION);
+   }
+
+   T ControlarEn(unsigned long TIEMPO, T MEDICION, T OBJETIVO)
+   {
+      Configuracion.Objetivo = OBJETIVO;
+      return ControlarEn(TIEMPO, MEDICION);
+   }
+
+   T ControlarEn(unsigned long TIEMPO, T MEDICION)
+                                          // Ver controlPID::ControlarEn(): con período fijo,
+                                          // TIEMPO sólo se registra.
+   {
+      unsigned long Intervalo = (PeriodoMuestreo>0) ? PeriodoMuestreo : TIEMPO - TiempoAnterior;
+      if (MuestraAnterior && Intervalo != PeriodoCoeficientes) {
+         CalcularCoeficientes(Intervalo);
+      }
+      T Error = Configuracion.Objetivo - MEDICION;
+      Admin.UltimaMedicion = MEDICION;
+
+      // PROPORCIONAL -----------------------------------------------------------------------------
+      Admin.ComponenteProporcional = Configuracion.Kp * Error;
+
+      // DERIVATIVO -------------------------------------------------------------------------------
+      if (MuestraAnterior && Configuracion.Td!=T(0)) {
+         Admin.ComponenteDerivativo = A::Multiplicar( Error-ErrorAnterior, Derivativo );
+      } else {
+         Admin.ComponenteDerivativo = T(0);
+      }
+
+      // ¿Debo compensar? -------------------------------------------------------------------------
+      Admin.Salida = Admin.ComponenteProporcional
+                   + Admin.ComponenteIntegral
+                   + Admin.ComponenteDerivativo;
+      Admin.Compensacion = T(0);
+      if (Configuracion.CompensarIntegral) {
+         if (Admin.Salida > Configuracion.LimiteSuperior) {
+            Admin.Compensacion = Admin.Salida - Configuracion.LimiteSuperior;
+         }
+         if (Admin.Salida < Configuracion.LimiteInferior) {
+            Admin.Compensacion = Admin.Salida - Configuracion.LimiteInferior;
+         }
+      }
+
+      // INTEGRAL ---------------------------------------------------------------------------------
+      if (MuestraAnterior && Configuracion.Ti!=T(0)) {
+         Admin.ComponenteIntegral += A::Multiplicar( Configuracion.Kp * (Error+ErrorAnterior)
+                                                   - (Admin.Compensacion+CompensacionAnterior),
+                                                     Integral );
+         if (LimitarSalida) {
+            Admin.ComponenteIntegral = Saturar(Admin.ComponenteIntegral);
+         }
+      }
+
+      // Cálculo final completo:
+      Admin.Salida = Admin.ComponenteProporcional
+                   + Admin.ComponenteIntegral
+                   + Admin.ComponenteDerivativo;
+      if (LimitarSalida) {
+         Admin.Salida = Saturar(Admin.Salida);
+      }
+
+      // Acción de control (si PIN_SALIDA está definido) ------------------------------------------
+      if (Etapa.Escribe()) {
+         Etapa.EscribirValor( A::AEscala( (Admin.Salida - Configuracion.LimiteInferior)
+                                          * InversaRango, Etapa.ValorMaximo() ) );
+      }
+
+      TiempoAnterior       = TIEMPO;
+      MuestraAnterior      = true;
+      ErrorAnterior        = Error;
+      CompensacionAnterior = Admin.Compensacion;
+      return Admin.Salida;
+   }
+
+   void Apagar()                          // Apaga el PID manteniendo configuración.
+   {
+      TiempoAnterior               = 0;
+      MuestraAnterior              = false;
+      ErrorAnterior                = T(0);
+      CompensacionAnterior         = T(0);
+      Admin.ComponenteIntegral     = T(0);
+      Admin.ComponenteProporcional = T(0);
+      Admin.ComponenteDerivativo   = T(0);
+      Etapa.Apagar();
+   }
+
+   uint8_t ResolucionPWM(uint8_t BITS)    // Ver controlPID
+   {
+      return Etapa.Resolucion(BITS);
+   }
+   void RegistroPWM(volatile uint8_t * REGISTRO)  { Etapa.Registro(REGISTRO); }
+   void RegistroPWM(volatile uint16_t * REGISTRO) { Etapa.Registro(REGISTRO); }
+
+   void Leer(pid_info_s * INFO)           // Lee la información convertida a float
+   {
+      *INFO = ConvertirInfo(Admin);
+   }
+
+   void Leer(pid_info_t<T> * INFO)        // Lee la información en el tipo propio
+   {
+      *INFO = Admin;
+   }
+
+   private:
+   void CalcularCoeficientes(unsigned long DT)
+   // Con DT = 0 (sin muestra anterior, o dos muestras en el mismo microsegundo) la derivada y
+   // la integral no suman.
+   {
+      PeriodoCoeficientes = DT;
+      Derivativo = (DT>0) ? A::SobreIntervalo(KpTd, DT) : A::CrearCoeficiente(0);
+      Integral   = A::PorIntervalo(InversaDosTi, DT);
+   }
+
+   T Saturar(T X) const
+   {
+      if (X > Configuracion.LimiteSuperior) return Configuracion.LimiteSuperior;
+      if (X < Configuracion.LimiteInferior) return Configuracion.LimiteInferior;
+      return X;
+   }
+};
+
+/*************************************************************************************************/
+
+#endif // CONTROL_PID_TIPO_SCA_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
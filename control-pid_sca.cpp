@@ -16,41 +16,124 @@ const float MILLON = 1e6;  // Constante para convertir micros() a segundos.
 * Funciones públicas
 **************************************************************************************************/
 
-controlPID::controlPID(uint8_t PIN_SALIDA)                   
+void CalcularCoeficientesPID(const pid_config_s * CONFIG, unsigned long PERIODO, 
+                             pid_coeficientes_s * COEF)
+// Coeficientes discretos de la configuración CONFIG. Con período fijo tampoco hace falta 
+// dividir por el intervalo: Controlar() queda sólo con productos y sumas.
+{
+   COEF->Kp         = CONFIG->Kp;
+   COEF->Derivativo = CONFIG->Kp * CONFIG->Td * MILLON;
+   if (CONFIG->Ti != 0) {
+      COEF->Integral = 1 / ( 2*CONFIG->Ti*MILLON );
+   } else {
+      COEF->Integral = 0;
+   }
+   if (PERIODO>0) {
+      COEF->Derivativo = COEF->Derivativo / PERIODO;
+      COEF->Integral   = COEF->Integral * PERIODO;
+   }
+   COEF->IntegralKp = CONFIG->Kp * COEF->Integral;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static inline void InterpolarCoeficientes(const pid_grilla_s * GRILLA, float MEDICION,
+                                          pid_coeficientes_s * COEF)
+// Ubica la variable en la grilla con una resta y un producto (una NaN queda en el primer nodo)
+// e interpola entre los dos nodos vecinos. Con nodos iguales los coeficientes son los del nodo.
 {
-   PinSalida = PIN_SALIDA;             // Guarda pin de salida y configura si corresponde
-   if (PinSalida>0) {
-      pinMode(PinSalida, OUTPUT);
-      analogWrite(PinSalida, 0);
+   float   Valor    = (GRILLA->Variable != 0) ? *GRILLA->Variable : MEDICION;
+   float   Posicion = (Valor - GRILLA->Minimo) * GRILLA->InversoPaso;
+   uint8_t i        = 0;
+   float   Fraccion = 0;
+   if (Posicion >= GRILLA->Cantidad-1) {
+      i        = GRILLA->Cantidad-2;
+      Fraccion = 1;
+   } else if (Posicion > 0) {
+      i        = uint8_t(Posicion);
+      Fraccion = Posicion - i;
    }
-   Admin = {};                         // Valores de administración reseteados.
+   const pid_nodo_s & A = GRILLA->Nodos[i];
+   const pid_nodo_s & B = GRILLA->Nodos[i+1];
+   COEF->Kp         = A.Kp         + Fraccion * (B.Kp         - A.Kp);
+   COEF->Derivativo = A.Derivativo + Fraccion * (B.Derivativo - A.Derivativo);
+   COEF->Integral   = A.Integral   + Fraccion * (B.Integral   - A.Integral);
+   COEF->IntegralKp = COEF->Kp * COEF->Integral;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+controlPID::controlPID(uint8_t PIN_SALIDA)                   
+{
+   Iniciar(PIN_SALIDA);
+}
+
+void controlPID::Iniciar(uint8_t PIN_SALIDA)
+{
+   Etapa.Iniciar(PIN_SALIDA);          // Guarda pin de salida y configura si corresponde
+   Salida               = 0;           // Valores de administración reseteados.
+   ComponenteIntegral   = 0;
+   ComponenteDerivativo = 0;
+   UltimaMedicion       = 0;
    Configuracion = {};                 // Configuración reseteada.
    Configuracion.Kp = 1;               // Valor predeterminado (resto dejamos en 0).
-   Configurar(Configuracion);          // Innecesario pero conveniente.
+   PeriodoMuestreo = 0;                // Tiempo medido con micros().
+   LeerReloj = micros;
+   Proveedor = 0;                      // Coeficientes de la configuración.
+   SecuenciaPendiente = 0;             // Sin reconfiguración pendiente.
+   HayPendiente       = false;
+#if PID_EVENTOS
+   Eventos(0, 0);                      // Evalúa todas las muestras.
+#endif
+#if PID_ESTADISTICAS
+   ConfigurarEstadisticas(0, 0);
+#endif
+   Configurar(&Configuracion);          // Innecesario pero conveniente.
 }
 
 //-------------------------------------------------------------------------------------------------
 
-void controlPID::Configurar(pid_config_s CONFIG)
+void controlPID::Configurar(pid_config_s * CONFIG)
 // Configura todos los parámetros.
 // Kp puede ser negativo.
 // Si Ti=0, el PID no lo tomará en cuenta.
 // Si Td=0, el PID no lo tomará en cuenta.
 {  
+   CargarConfiguracion(CONFIG);
+   HayPendiente = false;               // Descarta una reconfiguración sin aplicar
+
+   // Resetea valores de integración (aunque mantiene ComponenteIntegral)
+   TiempoAnterior       = 0;
+   MuestraAnterior      = false;
+   ErrorAnterior        = 0;
+   CompensacionAnterior = 0;
+
+   // Apago salida (si está activada)
+   Etapa.Apagar();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::CargarConfiguracion(pid_config_s * CONFIG)
+// Copia y verifica la configuración, corrigiendo CONFIG, y recalcula los coeficientes.
+{
    // Cargamos configuracion:
-   Configuracion.Objetivo          = CONFIG.Objetivo;
-   Configuracion.Kp                = CONFIG.Kp;
-   Configuracion.Ti                = CONFIG.Ti;
-   Configuracion.Td                = CONFIG.Td;
-   Configuracion.LimiteSuperior    = CONFIG.LimiteSuperior;
-   Configuracion.LimiteInferior    = CONFIG.LimiteInferior;
-   Configuracion.CompensarIntegral = CONFIG.CompensarIntegral;
+   Configuracion.Objetivo          = CONFIG->Objetivo;
+   Configuracion.Kp                = CONFIG->Kp;
+   Configuracion.Ti                = CONFIG->Ti;
+   Configuracion.Td                = CONFIG->Td;
+   Configuracion.LimiteSuperior    = CONFIG->LimiteSuperior;
+   Configuracion.LimiteInferior    = CONFIG->LimiteInferior;
+   Configuracion.CompensarIntegral = CONFIG->CompensarIntegral;
 
    // Verificaciones:
    if (Configuracion.LimiteSuperior < Configuracion.LimiteInferior) {
       float SW = Configuracion.LimiteSuperior;
       Configuracion.LimiteSuperior = Configuracion.LimiteInferior;
       Configuracion.LimiteInferior = SW;
+      // Corregimos CONFIG
+      CONFIG->LimiteSuperior = Configuracion.LimiteSuperior;
+      CONFIG->LimiteInferior = Configuracion.LimiteInferior;
    }
    if ( Configuracion.LimiteSuperior == Configuracion.LimiteInferior) {
       LimitarSalida = false;
@@ -58,20 +141,88 @@ void controlPID::Configurar(pid_config_s CONFIG)
       LimitarSalida = true;
    }
    CompensarIntegral(Configuracion.CompensarIntegral);
+   // Corregimos CONFIG si CompensarIntegral fue modificado:
+   CONFIG->CompensarIntegral = Configuracion.CompensarIntegral;  
+   CalcularCoeficientes();
+   Etapa.Escalar(Configuracion.LimiteInferior, Configuracion.LimiteSuperior);
+}
 
-   // Resetea valores de integración (aunque mantiene ComponenteIntegral)
-   TiempoAnterior       = 0;
-   ErrorAnterior        = 0;
-   CompensacionAnterior = 0;
+//-------------------------------------------------------------------------------------------------
 
-   // Apago salida (si está activada)
-   if (PinSalida>0) {
-      analogWrite(PinSalida, 0 );
+void controlPID::Reconfigurar(const pid_config_s * CONFIG)
+// Doble buffer con número de secuencia: la secuencia es impar mientras se copia CONFIG, así que
+// AplicarPendiente() nunca toma una configuración a medio escribir, aunque una llamada
+// interrumpa a la otra. La secuencia sólo detecta cambios durante la copia; que hay algo sin
+// aplicar lo indica HayPendiente, así que no importa cuántas veces se llame antes de aplicarla.
+// Un solo contexto debe escribir: dos Reconfigurar() que se interrumpan entre sí mezclan sus
+// copias con la secuencia par.
+{
+   SecuenciaPendiente = SecuenciaPendiente + 1;
+   __sync_synchronize();
+   ConfiguracionPendiente = *CONFIG;
+   HayPendiente = true;
+   __sync_synchronize();
+   SecuenciaPendiente = SecuenciaPendiente + 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool controlPID::ReconfiguracionPendiente()
+{
+   return HayPendiente;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::AplicarPendiente()
+// Aplica la configuración de Reconfigurar() sin reiniciar el cálculo. Para que la salida no 
+// salte, la integral absorbe el cambio del término proporcional de la última muestra (por 
+// cambio de Kp o de objetivo): Kp'*E' + I' = Kp*E + I. El error anterior se recalcula con el
+// nuevo objetivo, así un cambio de objetivo tampoco produce un pico en la derivada.
+// La marca se borra antes de copiar: un Reconfigurar() posterior la vuelve a poner, y uno que
+// llegue durante la copia cambia la secuencia y la copia se descarta.
+{
+   if (!HayPendiente) {
+      return;                             // Nada nuevo
+   }
+   uint8_t Secuencia = SecuenciaPendiente;
+   if (Secuencia & 1) {
+      return;                             // Reconfigurar() está escribiendo
+   }
+   HayPendiente = false;
+   __sync_synchronize();
+   pid_config_s Nueva = ConfiguracionPendiente;
+   __sync_synchronize();
+   if (SecuenciaPendiente != Secuencia) {
+      HayPendiente = true;
+      return;                             // Cambió durante la copia: se aplica la próxima vez
+   }
+#if PID_EVENTOS
+   EvaluarProxima = true;
+#endif
+   
+   float Parcial = Coeficientes.Kp * ErrorAnterior + ComponenteIntegral;
+   CargarConfiguracion(&Nueva);
+   if (MuestraAnterior) {
+      ErrorAnterior = Configuracion.Objetivo - UltimaMedicion;
+      ComponenteIntegral = Parcial - Coeficientes.Kp * ErrorAnterior;
+      if ( true==LimitarSalida ) {
+         ComponenteIntegral = min(ComponenteIntegral, Configuracion.LimiteSuperior);
+         ComponenteIntegral = max(ComponenteIntegral, Configuracion.LimiteInferior);
+      }
    }
 }
 
 //-------------------------------------------------------------------------------------------------
 
+void controlPID::Obtener(pid_config_s * CONFIG)
+// Copia la configuración vigente (con las correcciones hechas por Configurar).
+{
+   *CONFIG = Configuracion;
+}
+
+//-------------------------------------------------------------------------------------------------
+
 bool controlPID::CompensarIntegral()
 // Devuelve el valor de CompensaIntegral.
 {  
@@ -101,118 +252,416 @@ bool controlPID::CompensarIntegral(bool COMPENSAR)
 
 //-------------------------------------------------------------------------------------------------
 
+unsigned long controlPID::PeriodoFijo()
+// Devuelve el período fijo en microsegundos (0 si el tiempo se mide con micros).
+{
+   return PeriodoMuestreo;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned long controlPID::TiempoMuestra()
+// Devuelve el tiempo usado en el último Controlar(): el reloj, el TIEMPO de ControlarEn() o, con
+// período fijo, el tiempo acumulado desde Configurar(). Permite grabar y reproducir exactamente la ejecución.
+{
+   return TiempoAnterior;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::Reloj(unsigned long (*RELOJ)())
+{
+   LeerReloj = (RELOJ != 0) ? RELOJ : micros;
+}
+
+unsigned long controlPID::TiempoActual()
+{
+   return LeerReloj();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::ProveedorCoeficientes(proveedorCoeficientesPID * PROVEEDOR)
+{
+   Proveedor = PROVEEDOR;
+   CalcularCoeficientes();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned long controlPID::PeriodoFijo(unsigned long PERIODO)
+// Establece el período fijo de muestreo en microsegundos. Con PERIODO = 0 se vuelve a medir
+// el intervalo entre llamadas con micros().
+{
+   PeriodoMuestreo = PERIODO;
+   CalcularCoeficientes();
+   return PeriodoMuestreo;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::CalcularCoeficientes()
+// Precalcula los coeficientes discretos para que Controlar() no divida por Ti ni por MILLON.
+// Un proveedor recalcula lo suyo y deja los coeficientes de la última medición, para que
+// Leer() y el ajuste sin saltos de AplicarPendiente() usen la Kp que está actuando.
+{
+   CalcularCoeficientesPID(&Configuracion, PeriodoMuestreo, &Coeficientes);
+   if (Proveedor != 0) {
+      Proveedor->Calcular(&Configuracion, PeriodoMuestreo);
+      InterpolarCoeficientes(&Proveedor->Grilla, UltimaMedicion, &Coeficientes);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
 float controlPID::Controlar(float MEDICION)
 // Calcula Salida en función de la MEDICION de entrada y la configuración del PID
 {
-   TiempoActual = micros();
-   Admin.UltimaMedicion = MEDICION;
-   Error = Configuracion.Objetivo - MEDICION;
+   if (PeriodoMuestreo>0) {
+      // Período fijo: el tiempo avanza sin leer el reloj.
+      return ControlarEn(TiempoAnterior + PeriodoMuestreo, MEDICION);
+   }
+   return ControlarEn(LeerReloj(), MEDICION);
+}
+
+float controlPID::ControlarEn(unsigned long TIEMPO, float MEDICION)
+// La primera muestra se reconoce por MuestraAnterior y no por el tiempo, que puede valer 0.
+// Los intervalos se calculan como diferencia sin signo, correcta aunque el reloj desborde.
+// El error, el componente proporcional y la compensación sólo viven durante la llamada.
+// En el modo por eventos, la integral agrega el tiempo de las muestras omitidas, en el que el
+// error y la compensación se mantuvieron en los de la última evaluación (dentro de la banda),
+// y la derivada es la pendiente desde esa evaluación.
+{
+#if PID_ESTADISTICAS
+   unsigned long Entrada = micros();
+#endif
+   AplicarPendiente();
+#if PID_EVENTOS
+   if (Omitir(TIEMPO, MEDICION)) {
+#if PID_ESTADISTICAS
+      RegistrarEstadisticas(Entrada, false);
+#endif
+      return Salida;
+   }
+   unsigned long TiempoOmitido = TiempoAnterior - TiempoEvaluacion;
+   unsigned long Omitidos      = Consecutivas;
+   TiempoEvaluacion = TIEMPO;
+   Consecutivas     = 0;
+   ObjetivoEvaluado = Configuracion.Objetivo;
+   EvaluarProxima   = false;
+#else
+   const unsigned long TiempoOmitido = 0;
+   const unsigned long Omitidos      = 0;
+#endif
+   if (Proveedor != 0) {
+      InterpolarCoeficientes(&Proveedor->Grilla, MEDICION, &Coeficientes);
+   }
+   unsigned long Intervalo = TIEMPO - TiempoAnterior;
+   float         Error     = Configuracion.Objetivo - MEDICION;
+   UltimaMedicion = MEDICION;
    
    // PROPORCIONAL --------------------------------------------------------------------------------
-   Admin.ComponenteProporcional = Configuracion.Kp * Error;
+   float Proporcional = Coeficientes.Kp * Error;
 
    // DERIVATIVO ----------------------------------------------------------------------------------
-   if (TiempoAnterior>0 && Configuracion.Td!=0) {  
+   if (MuestraAnterior && Coeficientes.Derivativo!=0) {  
       // Dos condiciones para componente derivativa:
-      // 1) Que no sea el primer cálculo y 2) Td seteado
-      Admin.ComponenteDerivativo = Configuracion.Kp * Configuracion.Td
-                                 * (Error-ErrorAnterior) * MILLON 
-                                 / (TiempoActual-TiempoAnterior);
+      // 1) Que no sea el primer cálculo y 2) Kp*Td distinto de 0
+      // El error anterior es el de la última evaluación: con muestras omitidas el cambio se
+      // divide por todo el tiempo desde ella, no sólo por el último intervalo.
+      ComponenteDerivativo = Coeficientes.Derivativo * (Error-ErrorAnterior);
+      if (PeriodoMuestreo==0) {
+         ComponenteDerivativo = ComponenteDerivativo / (Intervalo + TiempoOmitido);
+      } else if (Omitidos > 0) {
+         ComponenteDerivativo = ComponenteDerivativo / float(Omitidos + 1);
+      }
    } else { 
-      Admin.ComponenteDerivativo = 0;
+      ComponenteDerivativo = 0;
    }
 
    // ¿Debo compensar? ----------------------------------------------------------------------------
-   Admin.Salida = Admin.ComponenteProporcional 
-                + Admin.ComponenteIntegral 
-                + Admin.ComponenteDerivativo;
-   Admin.Compensacion = 0;
+   Salida = Proporcional 
+          + ComponenteIntegral 
+          + ComponenteDerivativo;
+   float Compensacion = 0;
    if (Configuracion.CompensarIntegral) {
       // Si esto es true es porque había límites definidos correctamente
-      if (Admin.Salida > Configuracion.LimiteSuperior) {
+      if (Salida > Configuracion.LimiteSuperior) {
          // Debo compensar porque supera el máximo...
-         Admin.Compensacion = Admin.Salida - Configuracion.LimiteSuperior;
+         Compensacion = Salida - Configuracion.LimiteSuperior;
       }
-      if (Admin.Salida < Configuracion.LimiteInferior) {
+      if (Salida < Configuracion.LimiteInferior) {
          // Debo compensar porque está por debajo del mínimo...
-         Admin.Compensacion = Admin.Salida - Configuracion.LimiteInferior;
+         Compensacion = Salida - Configuracion.LimiteInferior;
       }      
    }
    
    // INTEGRAL ------------------------------------------------------------------------------------
-   if (TiempoAnterior>0 && Configuracion.Ti!=0) {
+   if (MuestraAnterior && Coeficientes.Integral!=0) {
       // Cumplidas las condiciones para integrar: (Si Compensacion==0, no va a compensar nada...)
-      Admin.ComponenteIntegral = Admin.ComponenteIntegral
-                               + ( Configuracion.Kp * (Error+ErrorAnterior) - (Admin.Compensacion+CompensacionAnterior) ) 
-                               * ( TiempoActual-TiempoAnterior ) 
-                               / ( 2*Configuracion.Ti*MILLON );
+      float Incremento = Coeficientes.IntegralKp * (Error+ErrorAnterior) 
+                       - Coeficientes.Integral * (Compensacion+CompensacionAnterior);
+      if (PeriodoMuestreo==0) {
+         Incremento = Incremento * Intervalo;
+      }
+      if (Omitidos > 0) {
+         // Rectángulos con el error y la compensación retenidos durante las muestras omitidas:
+         float Retenido = 2 * ( Coeficientes.IntegralKp * ErrorAnterior
+                              - Coeficientes.Integral * CompensacionAnterior );
+         Incremento = Incremento + Retenido * ( (PeriodoMuestreo==0) ? float(TiempoOmitido)
+                                                                      : float(Omitidos) );
+      }
+      ComponenteIntegral = ComponenteIntegral + Incremento;
       if ( true==LimitarSalida ) {
         // Debo saturar la integral: (se supone que esto sólo podría pasar si cambio los parámetros de integración)
-        Admin.ComponenteIntegral = min(Admin.ComponenteIntegral, Configuracion.LimiteSuperior);
-        Admin.ComponenteIntegral = max(Admin.ComponenteIntegral, Configuracion.LimiteInferior);
+        ComponenteIntegral = min(ComponenteIntegral, Configuracion.LimiteSuperior);
+        ComponenteIntegral = max(ComponenteIntegral, Configuracion.LimiteInferior);
       }
    }
 
    // Termina componente integral -----------------------------------------------------------------
    
    // Cáculo final completo: 
-   Admin.Salida = Admin.ComponenteProporcional 
-                + Admin.ComponenteIntegral 
-                + Admin.ComponenteDerivativo;
+   Salida = Proporcional 
+          + ComponenteIntegral 
+          + ComponenteDerivativo;
+#if PID_ESTADISTICAS
+   bool Saturada = LimitarSalida && ( Salida > Configuracion.LimiteSuperior 
+                                   || Salida < Configuracion.LimiteInferior );
+#endif
    if ( true==LimitarSalida ) {
       // Debo saturar la salida: (se supone que esto sólo podría pasar si cambio los parámetros de integración)
-      Admin.Salida = min(Admin.Salida, Configuracion.LimiteSuperior);
-      Admin.Salida = max(Admin.Salida, Configuracion.LimiteInferior);
+      Salida = min(Salida, Configuracion.LimiteSuperior);
+      Salida = max(Salida, Configuracion.LimiteInferior);
    }
    
    // Accion de control (si PIN_SALIDA está definido) ---------------------------------------------
-   if (PinSalida>0 && LimitarSalida ) {
-      analogWrite(PinSalida, int ( (Admin.Salida - Configuracion.LimiteInferior) 
-                                 / (Configuracion.LimiteSuperior - Configuracion.LimiteInferior) 
-                                 * 1014 ) );
-   }
+   EscribirSalida();
 
    // Termina funcion PID -------------------------------------------------------------------------
-   TiempoAnterior = TiempoActual;
+   TiempoAnterior = TIEMPO;
+   MuestraAnterior = true;
    ErrorAnterior = Error;
-   CompensacionAnterior = Admin.Compensacion;
-   return Admin.Salida;
+   CompensacionAnterior = Compensacion;
+#if PID_ESTADISTICAS
+   RegistrarEstadisticas(Entrada, Saturada);
+#endif
+   return Salida;
 }
 
 float controlPID::Controlar(float MEDICION, float OBJETIVO)
+// El OBJETIVO explícito prevalece sobre el de una reconfiguración pendiente.
 {
+   AplicarPendiente();
    Configuracion.Objetivo = OBJETIVO;
    return Controlar (MEDICION);
 }
 
+float controlPID::ControlarEn(unsigned long TIEMPO, float MEDICION, float OBJETIVO)
+{
+   AplicarPendiente();
+   Configuracion.Objetivo = OBJETIVO;
+   return ControlarEn(TIEMPO, MEDICION);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::EscribirSalida()
+// Escribe Salida en el PWM (si PIN_SALIDA está definido y hay límites). La escala se 
+// calculó al configurar y el valor sólo se escribe si cambió.
+{
+   Etapa.Escribir(Salida);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+uint8_t controlPID::ResolucionPWM(uint8_t BITS)
+{
+   return Etapa.Resolucion(BITS);
+}
+
+void controlPID::RegistroPWM(volatile uint8_t * REGISTRO)
+{
+   Etapa.Registro(REGISTRO);
+}
+
+void controlPID::RegistroPWM(volatile uint16_t * REGISTRO)
+{
+   Etapa.Registro(REGISTRO);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+float controlPID::SalidaManual(float SALIDA)
+// Impone la salida sin calcular el PID (por ejemplo, para autoajuste). Respeta los límites
+// y la escala del PWM de Controlar(). No modifica el estado del PID.
+{
+   Salida = SALIDA;
+   if ( true==LimitarSalida ) {
+      Salida = min(Salida, Configuracion.LimiteSuperior);
+      Salida = max(Salida, Configuracion.LimiteInferior);
+   }
+   EscribirSalida();
+   return Salida;
+}
+
 //-------------------------------------------------------------------------------------------------
 
 void controlPID::Apagar()
 {
    TiempoAnterior=0;
+   MuestraAnterior=false;
    ErrorAnterior=0;
    CompensacionAnterior=0;
-   Admin.ComponenteIntegral=0;   
-   Admin.ComponenteProporcional=0;
-   Admin.ComponenteDerivativo=0;
-   if (PinSalida>0) {
-      analogWrite(PinSalida, 0 );
-   } 
+   ComponenteIntegral=0;   
+   ComponenteDerivativo=0;
+   Etapa.Apagar();
 }
 
 //-------------------------------------------------------------------------------------------------
 
 void controlPID::Leer(pid_info_s * INFO)
+// Arma el informe a partir del estado: el proporcional es Kp por el último error (el mismo
+// producto que hizo Controlar) y la compensación es la que guardó para la muestra siguiente.
+{
+   INFO->Salida                 = Salida;
+   INFO->ComponenteProporcional = MuestraAnterior ? Coeficientes.Kp * ErrorAnterior : 0;
+   INFO->ComponenteIntegral     = ComponenteIntegral;
+   INFO->ComponenteDerivativo   = ComponenteDerivativo;
+   INFO->Compensacion           = CompensacionAnterior;
+   INFO->UltimaMedicion         = UltimaMedicion;
+   INFO->LimitarSalida          = LimitarSalida;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+#if PID_EVENTOS
+
+void controlPID::Eventos(float BANDA, unsigned long SILENCIO)
+{
+   BandaEventos     = BANDA;
+   SilencioMaximo   = SILENCIO;
+   Omitidas         = 0;
+   Consecutivas     = 0;
+   TiempoEvaluacion = TiempoAnterior;
+   ObjetivoEvaluado = Configuracion.Objetivo;
+   EvaluarProxima   = true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::ObtenerEventos(float * BANDA, unsigned long * SILENCIO)
+{
+   *BANDA    = BandaEventos;
+   *SILENCIO = SilencioMaximo;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned long controlPID::EvaluacionesOmitidas()
+{
+   return Omitidas;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool controlPID::Omitir(unsigned long TIEMPO, float MEDICION)
+// Se omite sólo si hubo una evaluación antes, medición y objetivo siguen dentro de la banda y
+// no se cumplió el silencio máximo. Con período fijo el tiempo omitido se cuenta en períodos,
+// porque TIEMPO sólo se registra.
+{
+   if (BandaEventos <= 0 || !MuestraAnterior || EvaluarProxima) {
+      return false;
+   }
+   if ( !(fabs(MEDICION - UltimaMedicion) <= BandaEventos) ||
+        !(fabs(Configuracion.Objetivo - ObjetivoEvaluado) <= BandaEventos) ) {
+      return false;                       // Se movió (o es NaN)
+   }
+   unsigned long Silencio = (PeriodoMuestreo>0) ? (Consecutivas+1) * PeriodoMuestreo
+                                                : TIEMPO - TiempoEvaluacion;
+   if (SilencioMaximo > 0 && Silencio >= SilencioMaximo) {
+      return false;
+   }
+   TiempoAnterior = TIEMPO;               // Controlar() con período fijo sigue avanzando
+   Consecutivas++;
+   Omitidas++;
+   return true;
+}
+
+#endif // PID_EVENTOS
+
+//-------------------------------------------------------------------------------------------------
+
+#if PID_ESTADISTICAS
+
+void controlPID::ConfigurarEstadisticas(unsigned long NOMINAL, unsigned long TOLERANCIA)
+// Si NOMINAL = 0 se toma el período fijo. Si TOLERANCIA = 0 se toma el 10% del nominal.
+{
+   IntervaloNominal = NOMINAL;
+   Tolerancia       = TOLERANCIA;
+   ReiniciarEstadisticas();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::ReiniciarEstadisticas()
+{
+   Estadisticas = {};
+   Estadisticas.TiempoMinimo = 0xFFFFFFFF;
+   TiempoTotal     = 0;
+   EntradaAnterior = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::LeerEstadisticas(pid_estadisticas_s * ESTADISTICAS)
 {
-   INFO->Salida                 = Admin.Salida;
-   INFO->ComponenteProporcional = Admin.ComponenteProporcional;
-   INFO->ComponenteIntegral     = Admin.ComponenteIntegral;
-   INFO->ComponenteDerivativo   = Admin.ComponenteDerivativo;
-   INFO->Compensacion           = Admin.Compensacion;
-   INFO->UltimaMedicion         = Admin.UltimaMedicion;
-   INFO->LimitarSalida          = Admin.LimitarSalida;
+   *ESTADISTICAS = Estadisticas;
+   if (Estadisticas.Llamadas > 0) {
+      ESTADISTICAS->TiempoMedio = float(TiempoTotal) / Estadisticas.Llamadas;
+   } else {
+      ESTADISTICAS->TiempoMinimo = 0;
+   }
 }
 
+//-------------------------------------------------------------------------------------------------
+
+void controlPID::RegistrarEstadisticas(unsigned long ENTRADA, bool SATURADA)
+// Se llama al final de Controlar() con el micros() de su comienzo.
+{
+   unsigned long Duracion = micros() - ENTRADA;
+   Estadisticas.Llamadas++;
+   TiempoTotal = TiempoTotal + Duracion;
+   Estadisticas.TiempoMinimo = min(Estadisticas.TiempoMinimo, Duracion);
+   Estadisticas.TiempoMaximo = max(Estadisticas.TiempoMaximo, Duracion);
+   if (SATURADA) {
+      Estadisticas.MuestrasSaturadas++;
+   }
+   
+   // Intervalo desde la llamada anterior (el real, aunque se use período fijo):
+   unsigned long Nominal = (IntervaloNominal>0) ? IntervaloNominal : PeriodoMuestreo;
+   if (Estadisticas.Llamadas > 1 && Nominal > 0) {
+      unsigned long Intervalo = ENTRADA - EntradaAnterior;
+      unsigned long Desvio    = (Tolerancia>0) ? Tolerancia : Nominal/10;
+      uint8_t Clase;
+      if (Intervalo + Desvio < Nominal) {
+         Clase = 0;
+      } else if (Intervalo > Nominal + Desvio) {
+         Clase = PID_HISTOGRAMA_CLASES-1;
+      } else {
+         // Clases intermedias: 1 a PID_HISTOGRAMA_CLASES-2 sobre [Nominal-Desvio, Nominal+Desvio]
+         Clase = 1 + (Intervalo + Desvio - Nominal) * (PID_HISTOGRAMA_CLASES-2) / (2*Desvio+1);
+      }
+      Estadisticas.Histograma[Clase]++;
+      if (Clase == 0 || Clase == PID_HISTOGRAMA_CLASES-1) {
+         Estadisticas.FueraDeTolerancia++;
+      }
+   }
+   EntradaAnterior = ENTRADA;
+}
+
+#endif // PID_ESTADISTICAS
+
 /**************************************************************************************************
 * FIN DE ARCHIVO control-pid_sca.cpp
 **************************************************************************************************/
\ No newline at end of file
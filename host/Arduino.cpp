@@ -0,0 +1,41 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/Arduino.cpp
+* Breve:      Implementación del sustituto de Arduino para PC. Ver host/Arduino.h.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+
+thread_local unsigned long RelojVirtual   = 0;
+thread_local unsigned long EscriturasPWM  = 0;
+thread_local uint8_t       UltimoPinPWM   = 0;
+thread_local int           UltimoValorPWM = 0;
+
+unsigned long micros()
+{
+   return RelojVirtual;
+}
+
+unsigned long millis()
+{
+   return RelojVirtual / 1000;
+}
+
+void pinMode(uint8_t PIN, uint8_t MODO)
+{
+   (void) PIN;
+   (void) MODO;
+}
+
+void analogWrite(uint8_t PIN, int VALOR)
+{
+   EscriturasPWM++;
+   UltimoPinPWM   = PIN;
+   UltimoValorPWM = VALOR;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/Arduino.cpp
+**************************************************************************************************/
@@ -0,0 +1,58 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/Arduino.h
+* Breve:      Sustituto mínimo de "Arduino.h" para compilar el módulo en una PC (Linux).
+*             Sólo provee lo que usan los módulos: micros(), millis(), pinMode(), analogWrite(),
+*             min(), max() y la interfaz Print de los puertos serie.
+*             El tiempo lo maneja el programa de prueba mediante RelojVirtual, y las escrituras
+*             PWM se cuentan en lugar de llegar a un pin real.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef ARDUINO_HOST_H
+#define ARDUINO_HOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+#define INPUT  0
+#define OUTPUT 1
+
+// Reloj virtual en microsegundos. micros() y millis() lo leen; el programa de prueba lo avanza.
+// Es propio de cada hilo, para poder simular varios sistemas en paralelo.
+extern thread_local unsigned long RelojVirtual;
+
+// Registro de la salida PWM simulada.
+extern thread_local unsigned long EscriturasPWM;   // Cantidad de llamadas a analogWrite()
+extern thread_local uint8_t       UltimoPinPWM;    // Último pin escrito
+extern thread_local int           UltimoValorPWM;  // Último valor escrito
+
+unsigned long micros();
+unsigned long millis();
+void pinMode(uint8_t PIN, uint8_t MODO);
+void analogWrite(uint8_t PIN, int VALOR);
+
+// Interfaz de salida de los puertos serie (subconjunto de la de Arduino).
+class Print
+{
+   public:
+   virtual ~Print() {}
+   virtual size_t write(uint8_t BYTE) = 0;
+   virtual size_t write(const uint8_t * DATOS, size_t LARGO)
+   {
+      size_t n = 0;
+      while (LARGO-- && write(*DATOS++)) n++;
+      return n;
+   }
+   virtual int availableForWrite() { return 0; }
+};
+
+// En Arduino min() y max() son macros; acá usamos plantillas para no romper la biblioteca estándar.
+template <typename T> inline T min(T A, T B) { return (A<B) ? A : B; }
+template <typename T> inline T max(T A, T B) { return (A>B) ? A : B; }
+
+#endif // ARDUINO_HOST_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
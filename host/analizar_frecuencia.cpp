@@ -0,0 +1,149 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/analizar_frecuencia.cpp
+* Breve:      Respuesta en frecuencia, márgenes de ganancia y de fase y picos de sensibilidad
+*             de controlPID con un modelo de planta, por simulación de la implementación
+*             discreta (ver host/frecuencia_pid.h). Con una configuración escribe en CSV el
+*             diagrama de Bode (L, controlador, planta, |S|, |T|) y los márgenes en stderr; con
+*             --lista escribe una línea de márgenes por configuración, para calificar miles de
+*             sintonías. Las frecuencias se reparten entre todos los núcleos.
+* Uso:        analizar_frecuencia [opciones] > bode.csv
+*               --kp K --ti S --td S  (predeterminado 5, 4, 0: los de Ejemplo_simulacion)
+*               --limites INF:SUP     (0:20)
+*               --compensar 0|1       (1)
+*               --lista ARCHIVO       Kp,Ti,Td,LimiteInferior,LimiteSuperior,CompensarIntegral
+*                                     por línea (como barrido_pid)
+*               --tau S --ganancia K --objetivo V --periodo US
+*               --retardo S           planta de primer orden con tiempo muerto
+*               --zeta Z              planta de segundo orden (Wn = 1/Tau)
+*               --desde HZ --hasta HZ --puntos N
+*               --amplitud A          perturbación (0: 1% del rango de la salida)
+*               --ciclos N            ciclos por ventana de medición (4)
+*               --asentamiento S      lazo cerrado antes de inyectar (0: automático)
+*               --multiseno           todas las frecuencias en una simulación
+*               --hilos N
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "frecuencia_pid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static void Uso()
+{
+   fprintf(stderr, "Uso: analizar_frecuencia [--kp K] [--ti S] [--td S] [--limites INF:SUP]\n"
+                   "                 [--compensar 0|1] [--lista ARCHIVO] [--tau S] [--ganancia K]\n"
+                   "                 [--objetivo V] [--periodo US] [--retardo S | --zeta Z]\n"
+                   "                 [--desde HZ] [--hasta HZ] [--puntos N] [--amplitud A]\n"
+                   "                 [--ciclos N] [--asentamiento S] [--multiseno] [--hilos N]\n");
+   exit(1);
+}
+
+static void ImprimirMargenes(FILE * F, const margenes_s & M)
+{
+   fprintf(F, "%g,%g,%g,%g,%g,%g,%g,%g,%u", M.MargenGanancia, M.FrecuenciaGanancia,
+           M.MargenFase, M.FrecuenciaFase, M.PicoSensibilidad, M.FrecuenciaSensibilidad,
+           M.PicoComplementaria, M.FrecuenciaComplementaria, M.Validos);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int main(int argc, char ** argv)
+{
+   analisis_frecuencia_s A    = AnalisisPredeterminado();
+   pid_config_s          C    = {};
+   const char *          Lista = NULL;
+   int                   Hilos = 0;
+   bool                  HastaDado = false, DesdeDado = false;
+   C.Kp = 5;  C.Ti = 4;  C.Td = 0;
+   C.LimiteInferior = 0;  C.LimiteSuperior = 20;  C.CompensarIntegral = true;
+
+   for (int i=1; i<argc; i++) {
+      if (!strcmp(argv[i], "--multiseno")) { A.Multiseno = true; continue; }
+      if (i+1 >= argc) Uso();
+      const char * Opcion = argv[i];
+      const char * Valor  = argv[++i];
+      if      (!strcmp(Opcion, "--kp"))           C.Kp = atof(Valor);
+      else if (!strcmp(Opcion, "--ti"))           C.Ti = atof(Valor);
+      else if (!strcmp(Opcion, "--td"))           C.Td = atof(Valor);
+      else if (!strcmp(Opcion, "--limites"))      { if (sscanf(Valor, "%f:%f", &C.LimiteInferior, &C.LimiteSuperior)!=2) Uso(); }
+      else if (!strcmp(Opcion, "--compensar"))    C.CompensarIntegral = atoi(Valor) != 0;
+      else if (!strcmp(Opcion, "--lista"))        Lista = Valor;
+      else if (!strcmp(Opcion, "--tau"))          A.Planta.Tau = atof(Valor);
+      else if (!strcmp(Opcion, "--retardo"))      { A.Planta.Retardo = atof(Valor); A.Planta.Modelo = MODELO_RETARDO; }
+      else if (!strcmp(Opcion, "--zeta"))         { A.Planta.Zeta = atof(Valor); A.Planta.Modelo = MODELO_SEGUNDO_ORDEN; }
+      else if (!strcmp(Opcion, "--ganancia"))     A.Planta.Ganancia = atof(Valor);
+      else if (!strcmp(Opcion, "--objetivo"))     A.Planta.Objetivo = atof(Valor);
+      else if (!strcmp(Opcion, "--periodo"))      A.Planta.Periodo = strtoul(Valor, NULL, 10);
+      else if (!strcmp(Opcion, "--desde"))        { A.Desde = atof(Valor); DesdeDado = true; }
+      else if (!strcmp(Opcion, "--hasta"))        { A.Hasta = atof(Valor); HastaDado = true; }
+      else if (!strcmp(Opcion, "--puntos"))       A.Puntos = atoi(Valor);
+      else if (!strcmp(Opcion, "--amplitud"))     A.Amplitud = atof(Valor);
+      else if (!strcmp(Opcion, "--ciclos"))       A.Ciclos = atoi(Valor);
+      else if (!strcmp(Opcion, "--asentamiento")) A.Asentamiento = atof(Valor);
+      else if (!strcmp(Opcion, "--hilos"))        Hilos = atoi(Valor);
+      else Uso();
+   }
+   if (A.Planta.Periodo == 0 || A.Planta.Tau <= 0 || A.Puntos == 0 || A.Ciclos == 0) Uso();
+   if (!DesdeDado) A.Desde = 1 / (1000 * A.Planta.Tau);
+   if (!HastaDado) A.Hasta = 0.45e6 / A.Planta.Periodo;
+   if (A.Desde <= 0 || A.Hasta < A.Desde || A.Hasta >= 0.5e6 / A.Planta.Periodo) {
+      fprintf(stderr, "Frecuencias fuera de rango (0 < desde <= hasta < %g Hz)\n",
+              0.5e6 / A.Planta.Periodo);
+      return 1;
+   }
+   A.Planta.Inicial = 0;
+
+   std::vector<pid_config_s> Configs;
+   if (Lista) {
+      if (!LeerCandidatos(Lista, &Configs)) {
+         fprintf(stderr, "No se pudo leer %s\n", Lista);
+         return 1;
+      }
+   } else {
+      Configs.push_back(C);
+   }
+
+   std::vector<punto_frecuencia_s> Puntos(Configs.size() * A.Puntos);
+   std::vector<margenes_s>         Margenes(Configs.size());
+   double Segundos = AnalizarConfiguraciones(Configs.data(), Configs.size(), &A, Puntos.data(),
+                                             Margenes.data(), Hilos);
+
+   if (!Lista) {
+      printf("Frecuencia,LazoModulo,LazoFase,ControladorModulo,ControladorFase,PlantaModulo,"
+             "PlantaFase,Sensibilidad,Complementaria,Distorsion,Valido\n");
+      for (const punto_frecuencia_s & P : Puntos) {
+         printf("%g,%g,%g,%g,%g,%g,%g,%g,%g,%g,%d\n", P.Frecuencia, P.LazoModulo, P.LazoFase,
+                P.ControladorModulo, P.ControladorFase, P.PlantaModulo, P.PlantaFase,
+                P.Sensibilidad, P.Complementaria, P.Distorsion, P.Valido);
+      }
+      const margenes_s & M = Margenes[0];
+      fprintf(stderr, "Margen de ganancia %.2f dB a %.4g Hz, margen de fase %.1f grados a %.4g Hz\n"
+                      "Ms %.3f a %.4g Hz, Mt %.3f a %.4g Hz (%u de %u puntos validos)\n",
+              M.MargenGanancia, M.FrecuenciaGanancia, M.MargenFase, M.FrecuenciaFase,
+              M.PicoSensibilidad, M.FrecuenciaSensibilidad, M.PicoComplementaria,
+              M.FrecuenciaComplementaria, M.Validos, A.Puntos);
+   } else {
+      printf("Kp,Ti,Td,LimiteInferior,LimiteSuperior,CompensarIntegral,MargenGanancia,"
+             "FrecuenciaGanancia,MargenFase,FrecuenciaFase,PicoSensibilidad,"
+             "FrecuenciaSensibilidad,PicoComplementaria,FrecuenciaComplementaria,Validos\n");
+      for (size_t i=0; i<Configs.size(); i++) {
+         const pid_config_s & K = Configs[i];
+         printf("%g,%g,%g,%g,%g,%d,", K.Kp, K.Ti, K.Td, K.LimiteInferior, K.LimiteSuperior,
+                K.CompensarIntegral);
+         ImprimirMargenes(stdout, Margenes[i]);
+         printf("\n");
+      }
+   }
+   fprintf(stderr, "%zu configuraciones x %u frecuencias en %.3f s\n", Configs.size(),
+           A.Puntos, Segundos);
+   return 0;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/analizar_frecuencia.cpp
+**************************************************************************************************/
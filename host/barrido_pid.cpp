@@ -0,0 +1,133 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/barrido_pid.cpp
+* Breve:      Barrido de sintonías en simulación. Arma una grilla (o lee una lista) de
+*             candidatos (Kp, Ti, Td, límites, CompensarIntegral), los simula en paralelo contra
+*             la planta de Ejemplo_simulacion y escribe las métricas de cada uno en CSV.
+* Uso:        barrido_pid [opciones] > resultados.csv
+*               --kp MIN:MAX:PASOS    (predeterminado 1:10:10)
+*               --ti MIN:MAX:PASOS    (0:8:9)          Ti=0 no integra
+*               --td MIN:MAX:PASOS    (0:1:5)          Td=0 no deriva
+*               --limites INF:SUP     (0:20)
+*               --compensar 0|1|2     (2: ambos)
+*               --lista ARCHIVO       Kp,Ti,Td,LimiteInferior,LimiteSuperior,CompensarIntegral
+*                                     por línea (reemplaza a la grilla)
+*               --tau S --ganancia K --objetivo V --periodo US --duracion S --hilos N
+*               --retardo S           planta de primer orden con tiempo muerto
+*               --zeta Z              planta de segundo orden (Wn = 1/Tau)
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "simulador_pid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+struct rango_s {
+   float Minimo;
+   float Maximo;
+   int   Pasos;
+   float Valor(int i) const { return (Pasos>1) ? Minimo + (Maximo-Minimo)*i/(Pasos-1) : Minimo; }
+};
+
+static bool LeerRango(const char * TEXTO, rango_s * R)
+{
+   return sscanf(TEXTO, "%f:%f:%d", &R->Minimo, &R->Maximo, &R->Pasos) == 3 && R->Pasos > 0;
+}
+
+static void Uso()
+{
+   fprintf(stderr, "Uso: barrido_pid [--kp MIN:MAX:PASOS] [--ti ...] [--td ...] [--limites INF:SUP]\n"
+                   "                 [--compensar 0|1|2] [--lista ARCHIVO] [--tau S] [--ganancia K]\n"
+                   "                 [--objetivo V] [--periodo US] [--duracion S] [--hilos N]\n"
+                   "                 [--retardo S | --zeta Z]\n");
+   exit(1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int main(int argc, char ** argv)
+{
+   simulacion_s Sim = SimulacionPredeterminada();
+   rango_s Kp = {1, 10, 10}, Ti = {0, 8, 9}, Td = {0, 1, 5};
+   float   Inferior = 0, Superior = 20;
+   int     Compensar = 2;
+   unsigned int Hilos = 0;
+   std::vector<pid_config_s> Candidatos;
+   const char * Lista = NULL;
+   
+   for (int i=1; i<argc; i++) {
+      if (i+1 >= argc) Uso();
+      const char * Opcion = argv[i];
+      const char * Valor  = argv[++i];
+      if      (!strcmp(Opcion, "--kp"))        { if (!LeerRango(Valor, &Kp)) Uso(); }
+      else if (!strcmp(Opcion, "--ti"))        { if (!LeerRango(Valor, &Ti)) Uso(); }
+      else if (!strcmp(Opcion, "--td"))        { if (!LeerRango(Valor, &Td)) Uso(); }
+      else if (!strcmp(Opcion, "--limites"))   { if (sscanf(Valor, "%f:%f", &Inferior, &Superior)!=2) Uso(); }
+      else if (!strcmp(Opcion, "--compensar")) Compensar = atoi(Valor);
+      else if (!strcmp(Opcion, "--lista"))     Lista = Valor;
+      else if (!strcmp(Opcion, "--tau"))       Sim.Tau = atof(Valor);
+      else if (!strcmp(Opcion, "--retardo"))   { Sim.Retardo = atof(Valor); Sim.Modelo = MODELO_RETARDO; }
+      else if (!strcmp(Opcion, "--zeta"))      { Sim.Zeta = atof(Valor); Sim.Modelo = MODELO_SEGUNDO_ORDEN; }
+      else if (!strcmp(Opcion, "--ganancia"))  Sim.Ganancia = atof(Valor);
+      else if (!strcmp(Opcion, "--objetivo"))  Sim.Objetivo = atof(Valor);
+      else if (!strcmp(Opcion, "--periodo"))   Sim.Periodo = strtoul(Valor, NULL, 10);
+      else if (!strcmp(Opcion, "--duracion"))  Sim.Duracion = atof(Valor);
+      else if (!strcmp(Opcion, "--hilos"))     Hilos = atoi(Valor);
+      else Uso();
+   }
+   if (Sim.Periodo == 0 || Sim.Tau <= 0) Uso();
+   
+   if (Lista) {
+      if (!LeerCandidatos(Lista, &Candidatos)) {
+         fprintf(stderr, "No se pudo leer %s\n", Lista);
+         return 1;
+      }
+   } else {
+      for (int a=0; a<Kp.Pasos; a++)
+      for (int b=0; b<Ti.Pasos; b++)
+      for (int c=0; c<Td.Pasos; c++)
+      for (int d=(Compensar==1); d<=(Compensar>=1); d++) {
+         pid_config_s C = {};
+         C.Kp = Kp.Valor(a);
+         C.Ti = Ti.Valor(b);
+         C.Td = Td.Valor(c);
+         C.LimiteInferior    = Inferior;
+         C.LimiteSuperior    = Superior;
+         C.CompensarIntegral = (d==1);
+         Candidatos.push_back(C);
+      }
+   }
+   
+   std::vector<metricas_s> Resultados(Candidatos.size());
+   double Segundos = SimularCandidatos(Candidatos.data(), Resultados.data(), Candidatos.size(),
+                                       &Sim, Hilos);
+   
+   printf("Kp,Ti,Td,LimiteInferior,LimiteSuperior,CompensarIntegral,"
+          "IAE,ISE,Sobrepico,TiempoEstablecimiento,TiempoSaturado\n");
+   size_t Mejor = 0;
+   for (size_t i=0; i<Candidatos.size(); i++) {
+      const pid_config_s & C = Candidatos[i];
+      const metricas_s   & M = Resultados[i];
+      printf("%g,%g,%g,%g,%g,%d,%g,%g,%g,%g,%g\n", C.Kp, C.Ti, C.Td, C.LimiteInferior,
+             C.LimiteSuperior, C.CompensarIntegral, M.IAE, M.ISE, M.Sobrepico, 
+             M.TiempoEstablecimiento, M.TiempoSaturado);
+      if (M.IAE < Resultados[Mejor].IAE) Mejor = i;
+   }
+   
+   fprintf(stderr, "%zu candidatos en %.3f s (%.0f candidatos/s)\n", Candidatos.size(), Segundos,
+           Candidatos.size() / Segundos);
+   if (!Candidatos.empty()) {
+      fprintf(stderr, "Menor IAE: Kp=%g Ti=%g Td=%g CompensarIntegral=%d (IAE=%g)\n",
+              Candidatos[Mejor].Kp, Candidatos[Mejor].Ti, Candidatos[Mejor].Td,
+              Candidatos[Mejor].CompensarIntegral, Resultados[Mejor].IAE);
+   }
+   return 0;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/barrido_pid.cpp
+**************************************************************************************************/
@@ -0,0 +1,144 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/benchmark_flota.cpp
+* Breve:      Mide flotaPID con N lazos PI, cada uno contra su propia planta de primer orden,
+*             repartidos en cuatro grupos (1, 2, 5 y 10 ms):
+*             1) Capacidad: lazos por segundo en modo libre (sin reloj) según la cantidad de
+*                hilos, de 1 al doble de los núcleos.
+*             2) Tiempo real: ejecución con la rueda de tiempo y plazos vencidos por grupo.
+* Uso:        benchmark_flota [--lazos N] [--segundos S] [--hilos N] [--afinidad] [--fifo P]
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "flota_pid.h"
+#include "control-pid-planta_sca.h"
+#include "medicion.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+static const unsigned long Periodos[] = { 1000, 2000, 5000, 10000 };
+
+struct lazo_prueba_s {
+   plantaPrimerOrden Planta;
+   unsigned long     Periodo;
+   lazo_prueba_s(unsigned long PERIODO) : Planta(1, 0.05f, 0), Periodo(PERIODO) {}
+};
+
+static float Medir(void * CONTEXTO)
+{
+   return ((lazo_prueba_s *) CONTEXTO)->Planta.Salida();
+}
+
+static void Actuar(void * CONTEXTO, float SALIDA)
+{
+   lazo_prueba_s * L = (lazo_prueba_s *) CONTEXTO;
+   L->Planta.Simular(SALIDA, L->Periodo);
+}
+
+static void Uso()
+{
+   fprintf(stderr, "Uso: benchmark_flota [--lazos N] [--segundos S] [--hilos N] [--afinidad]"
+                   " [--fifo P]\n");
+   exit(1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int main(int argc, char ** argv)
+{
+   unsigned int     Lazos    = 20000;
+   double           Segundos = 1;
+   flota_opciones_s Opciones = {};
+
+   for (int i=1; i<argc; i++) {
+      if      (!strcmp(argv[i], "--afinidad")) Opciones.Afinidad = true;
+      else if (i+1 >= argc)                    Uso();
+      else if (!strcmp(argv[i], "--lazos"))    Lazos = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "--segundos")) Segundos = atof(argv[++i]);
+      else if (!strcmp(argv[i], "--hilos"))    Opciones.Hilos = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "--fifo"))     Opciones.PrioridadFIFO = atoi(argv[++i]);
+      else Uso();
+   }
+   if (Lazos == 0 || Segundos <= 0) Uso();
+
+   pid_config_s Config = {};
+   Config.Objetivo          = 10;
+   Config.Kp                = 2;
+   Config.Ti                = 0.1f;
+   Config.LimiteSuperior    = 20;
+   Config.LimiteInferior    = 0;
+   Config.CompensarIntegral = true;
+
+   std::vector<controlPID>    PIDs(Lazos, controlPID(PID_SIN_SALIDA));
+   std::vector<lazo_prueba_s> Plantas;
+   flotaPID                   Flota;
+   Plantas.reserve(Lazos);
+   for (unsigned int i=0; i<Lazos; i++) {
+      unsigned long Periodo = Periodos[i % 4];
+      Plantas.emplace_back(Periodo);
+      PIDs[i].Configurar(&Config);
+      Flota.Agregar(&PIDs[i], Medir, Actuar, &Plantas[i], Periodo);
+   }
+
+   // 1) Capacidad según hilos --------------------------------------------------------------------
+   unsigned int Nucleos = std::thread::hardware_concurrency();
+   if (Nucleos == 0) Nucleos = 1;
+   printf("%u lazos, %u grupos, %u nucleos\n\nCapacidad (modo libre)\n", Lazos,
+          Flota.CantidadGrupos(), Nucleos);
+   printf("%6s %16s %10s\n", "hilos", "lazos/s", "escala");
+   double Referencia = 0;
+   for (unsigned int Hilos=1; Hilos<=2*Nucleos; Hilos*=2) {
+      flota_opciones_s Libre = Opciones;
+      Libre.Hilos = Hilos;
+      Libre.Libre = true;
+      unsigned long Antes = 0, Despues = 0;
+      flota_grupo_info_s Info;
+      for (unsigned int g=0; g<Flota.CantidadGrupos(); g++) {
+         Flota.Leer(g, &Info);
+         Antes += Info.LazosEjecutados;
+      }
+      double Inicio = SegundosMonotonicos();
+      Flota.Iniciar(&Libre);
+      while (SegundosMonotonicos() - Inicio < Segundos) {
+         usleep(10000);
+      }
+      Flota.Detener();
+      double Transcurrido = SegundosMonotonicos() - Inicio;
+      for (unsigned int g=0; g<Flota.CantidadGrupos(); g++) {
+         Flota.Leer(g, &Info);
+         Despues += Info.LazosEjecutados;
+      }
+      double PorSegundo = (Despues - Antes) / Transcurrido;
+      if (Hilos == 1) Referencia = PorSegundo;
+      printf("%6u %16.0f %9.2fx\n", Hilos, PorSegundo, PorSegundo / Referencia);
+   }
+
+   // 2) Tiempo real ------------------------------------------------------------------------------
+   flotaPID Real;
+   for (unsigned int i=0; i<Lazos; i++) {
+      Real.Agregar(&PIDs[i], Medir, Actuar, &Plantas[i], Plantas[i].Periodo);
+   }
+   bool Opcional = Real.Iniciar(&Opciones);
+   usleep(useconds_t(Segundos * 1e6));
+   Real.Detener();
+   printf("\nTiempo real, %u hilos%s\n", Real.CantidadHilos(),
+          Opcional ? "" : " (no se pudo aplicar afinidad o SCHED_FIFO)");
+   printf("%10s %8s %12s %10s %10s %14s\n",
+          "periodo us", "lazos", "liberaciones", "vencidos", "omitidos", "respuesta max");
+   for (unsigned int g=0; g<Real.CantidadGrupos(); g++) {
+      flota_grupo_info_s Info;
+      Real.Leer(g, &Info);
+      printf("%10lu %8u %12lu %10lu %10lu %11lu us\n", Info.Periodo, Info.Lazos,
+             Info.Liberaciones, Info.Vencidos, Info.Omitidos, Info.RespuestaMaxima);
+   }
+   return 0;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/benchmark_flota.cpp
+**************************************************************************************************/
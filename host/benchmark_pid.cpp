@@ -0,0 +1,562 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/benchmark_pid.cpp
+* Breve:      Mide el costo de controlPID::Controlar() en PC para detectar regresiones de
+*             rendimiento. Informa ns/llamada e instrucciones/llamada para cada configuración:
+*             P, PI y PID; sin límites, con límites y con límites más compensación de integral;
+*             y para las dos variantes Controlar(MEDICION) y Controlar(MEDICION, OBJETIVO).
+*             Compara el período medido con micros() contra el período fijo (PeriodoFijo()).
+*             Mide el banco vectorial controlPIDBanco<N> para N de 1 a 100000, contra N objetos
+*             controlPID, y verifica que los resultados sean idénticos.
+*             Compara además precisión y costo de controlPIDT<float>, <double> y <fijoQ16>, y
+*             el de controlPIDFijo (estructura y sintonía fijadas al compilar) contra controlPID.
+*             Compara una cascada de dos lazos con grafoPID contra el mismo cableado a mano.
+*             Mide controlPIDProgramado (ganancias programadas) contra controlPID.
+*             Mide la etapa de salida PWM: sin salida, con analogWrite() y con escritura directa
+*             en un registro, y cuántas escrituras llegan al PWM por muestra.
+*             Mide la etapa de entrada entradaPID por lectura y, en un lazo simulado con un
+*             sensor ruidoso sobremuestreado, cuánto reduce el ruido que llega a la salida.
+*             Termina con código 1 si alguna comparación de identidad marca DIFIERE.
+* Uso:        make -C host bench
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+#include "control-pid-tipo_sca.h"
+#include "control-pid-banco_sca.h"
+#include "control-pid-fijo_sca.h"
+#include "control-pid-cascada_sca.h"
+#include "control-pid-programado_sca.h"
+#include "control-pid-entrada_sca.h"
+#include "control-pid-planta_sca.h"
+#include "medicion.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define PIN_PWM          3         // Pin ficticio: así se incluye el costo de analogWrite()
+#define PERIODO_US       1000      // Intervalo simulado entre muestras
+#define MUESTRAS         1024      // Tabla de mediciones (potencia de 2)
+#define ITERACIONES      2000000UL
+
+static float Mediciones[MUESTRAS];
+static volatile float Sumidero;    // Evita que el optimizador descarte los resultados
+static bool Diferencias;           // Alguna variante no dio salidas idénticas a controlPID
+
+struct estructura_s {
+   const char * Nombre;
+   float Ti;
+   float Td;
+};
+
+struct limites_s {
+   const char * Nombre;
+   float LimiteSuperior;
+   float LimiteInferior;
+   bool  CompensarIntegral;
+};
+
+static const estructura_s Estructuras[] = {
+   { "P",   0, 0    },
+   { "PI",  4, 0    },
+   { "PID", 4, 0.5f },
+};
+
+static const limites_s Limites[] = {
+   { "sin limites",         0,  0, false },
+   { "con limites",        20,  0, false },
+   { "con limites+compens", 20,  0, true  },
+};
+
+//-------------------------------------------------------------------------------------------------
+
+static pid_config_s ConfiguracionPrueba(const estructura_s & E, const limites_s & L)
+{
+   pid_config_s Config = {};
+   Config.Objetivo          = 10;
+   Config.Kp                = 5;
+   Config.Ti                = E.Ti;
+   Config.Td                = E.Td;
+   Config.LimiteSuperior    = L.LimiteSuperior;
+   Config.LimiteInferior    = L.LimiteInferior;
+   Config.CompensarIntegral = L.CompensarIntegral;
+   return Config;
+}
+
+static void MedirControlar()
+{
+   char Nombre[64];
+   
+   for (const estructura_s & E : Estructuras) {
+      for (const limites_s & L : Limites) {
+         pid_config_s Config = ConfiguracionPrueba(E, L);
+         controlPID   PID(PIN_PWM);
+         
+         RelojVirtual = PERIODO_US;
+         PID.Configurar(&Config);
+         medicion_s M1 = Medir([&](unsigned long i) {
+            RelojVirtual += PERIODO_US;
+            Sumidero = PID.Controlar(Mediciones[i & (MUESTRAS-1)]);
+         }, ITERACIONES);
+         snprintf(Nombre, sizeof(Nombre), "%-3s %-20s Controlar(M)", E.Nombre, L.Nombre);
+         ImprimirMedicion(Nombre, M1);
+         
+         PID.Configurar(&Config);
+         medicion_s M2 = Medir([&](unsigned long i) {
+            RelojVirtual += PERIODO_US;
+            Sumidero = PID.Controlar(Mediciones[i & (MUESTRAS-1)], (i & 4096) ? 10.0f : 12.0f);
+         }, ITERACIONES);
+         snprintf(Nombre, sizeof(Nombre), "%-3s %-20s Controlar(M,O)", E.Nombre, L.Nombre);
+         ImprimirMedicion(Nombre, M2);
+      }
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static void MedirPeriodoFijo()
+{
+   char Nombre[64];
+   
+   for (const estructura_s & E : Estructuras) {
+      pid_config_s Config = ConfiguracionPrueba(E, Limites[2]);
+      controlPID   PID(PIN_PWM);
+      medicion_s   M[2];
+      
+      for (int Fijo=0; Fijo<2; Fijo++) {
+         PID.PeriodoFijo(Fijo ? PERIODO_US : 0);
+         RelojVirtual = PERIODO_US;
+         PID.Configurar(&Config);
+         M[Fijo] = Medir([&](unsigned long i) {
+            RelojVirtual += PERIODO_US;
+            Sumidero = PID.Controlar(Mediciones[i & (MUESTRAS-1)]);
+         }, ITERACIONES);
+         snprintf(Nombre, sizeof(Nombre), "%-3s %-20s %s", E.Nombre, Limites[2].Nombre, 
+                  Fijo ? "periodo fijo" : "periodo medido");
+         ImprimirMedicion(Nombre, M[Fijo]);
+      }
+      printf("%-44s %9.2fx\n", "   aceleracion", M[0].NsPorLlamada / M[1].NsPorLlamada);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+// Configuración variada para el lazo i del banco: recorre estructuras, límites y ganancias.
+static pid_config_s ConfiguracionLazo(unsigned int i)
+{
+   pid_config_s Config = ConfiguracionPrueba(Estructuras[i % 3], Limites[(i/3) % 3]);
+   Config.Kp       = 1 + (i % 7);
+   Config.Objetivo = 8 + (i % 5);
+   return Config;
+}
+
+template <unsigned int N>
+static void MedirBanco()
+{
+   controlPIDBanco<N> * Banco = new controlPIDBanco<N>(PERIODO_US);
+   std::vector<controlPID> Lazos(N, controlPID(PID_SIN_SALIDA));
+   std::vector<float> Entradas(N), SalidaBanco(N), SalidaLazos(N);
+   unsigned long Ticks = (ITERACIONES/N > 0) ? ITERACIONES/N : 1;
+   bool Identicos = true;
+   char Nombre[64];
+   
+   for (unsigned int i=0; i<N; i++) {
+      pid_config_s Config = ConfiguracionLazo(i);
+      Lazos[i].PeriodoFijo(PERIODO_US);
+      Lazos[i].Configurar(&Config);
+      Config = ConfiguracionLazo(i);
+      Banco->Configurar(i, &Config);
+   }
+   
+   // Verificación: mismas salidas, bit a bit, durante algunos tics
+   for (int Tic=0; Tic<50 && Identicos; Tic++) {
+      for (unsigned int i=0; i<N; i++) {
+         Entradas[i]    = Mediciones[(i*7+Tic) & (MUESTRAS-1)];
+         SalidaLazos[i] = Lazos[i].Controlar(Entradas[i]);
+      }
+      Banco->Controlar(Entradas.data(), SalidaBanco.data());
+      Identicos = (memcmp(SalidaBanco.data(), SalidaLazos.data(), N*sizeof(float)) == 0);
+   }
+   
+   medicion_s MB = Medir([&](unsigned long t) {
+      Entradas[t % N] = Mediciones[t & (MUESTRAS-1)];
+      Banco->Controlar(Entradas.data(), SalidaBanco.data());
+   }, Ticks);
+   medicion_s ML = Medir([&](unsigned long t) {
+      Entradas[t % N] = Mediciones[t & (MUESTRAS-1)];
+      for (unsigned int i=0; i<N; i++) SalidaLazos[i] = Lazos[i].Controlar(Entradas[i]);
+   }, Ticks);
+   Sumidero = SalidaBanco[0] + SalidaLazos[0];
+   
+   // Costo por lazo
+   MB.NsPorLlamada /= N;  MB.InstruccionesPorLlamada /= (MB.InstruccionesPorLlamada<0) ? 1 : N;
+   ML.NsPorLlamada /= N;  ML.InstruccionesPorLlamada /= (ML.InstruccionesPorLlamada<0) ? 1 : N;
+   snprintf(Nombre, sizeof(Nombre), "N=%-6u banco (%s)", N, Identicos ? "identico" : "DIFIERE");
+   Diferencias = Diferencias || !Identicos;
+   ImprimirMedicion(Nombre, MB);
+   snprintf(Nombre, sizeof(Nombre), "N=%-6u controlPID", N);
+   ImprimirMedicion(Nombre, ML);
+   delete Banco;
+}
+
+static void MedirBancos()
+{
+   MedirBanco<1>();
+   MedirBanco<10>();
+   MedirBanco<100>();
+   MedirBanco<1000>();
+   MedirBanco<10000>();
+   MedirBanco<100000>();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+// Intervalo entre muestras: PERIODO_US, o con JITTER un valor distinto en cada muestra (los
+// coeficientes que dependen del intervalo se recalculan en cada llamada).
+static unsigned long Intervalo(unsigned long i, bool JITTER)
+{
+   return JITTER ? PERIODO_US - 50 + (i * 37) % 101 : PERIODO_US;
+}
+
+// Error máximo de la salida respecto de controlPIDT<double> con la misma secuencia de mediciones.
+template <typename T>
+static double ErrorMaximo(pid_config_s CONFIG, bool JITTER)
+{
+   controlPIDT<double> Referencia(PID_SIN_SALIDA);
+   controlPIDT<T>      PID(PID_SIN_SALIDA);
+   double Maximo = 0;
+   
+   RelojVirtual = PERIODO_US;
+   Referencia.Configurar(&CONFIG);
+   PID.Configurar(&CONFIG);
+   for (int i=0; i<100000; i++) {
+      RelojVirtual += Intervalo(i, JITTER);
+      double R = Referencia.Controlar( double(Mediciones[i & (MUESTRAS-1)]) );
+      double S = double( PID.Controlar( T(Mediciones[i & (MUESTRAS-1)]) ) );
+      Maximo = fmax( Maximo, fabs(S-R) );
+   }
+   return Maximo;
+}
+
+template <typename T>
+static void MedirTipo(const char * NOMBRE, pid_config_s CONFIG, bool JITTER)
+{
+   static T Entradas[MUESTRAS];
+   controlPIDT<T> PID(PIN_PWM);
+   char Nombre[64];
+   
+   for (int i=0; i<MUESTRAS; i++) Entradas[i] = T(Mediciones[i]);
+   RelojVirtual = PERIODO_US;
+   PID.Configurar(&CONFIG);
+   medicion_s M = Medir([&](unsigned long i) {
+      RelojVirtual += Intervalo(i, JITTER);
+      Sumidero = float( PID.Controlar(Entradas[i & (MUESTRAS-1)]) );
+   }, ITERACIONES);
+   snprintf(Nombre, sizeof(Nombre), "controlPIDT<%s> (error max %.2e)", NOMBRE,
+            ErrorMaximo<T>(CONFIG, JITTER));
+   ImprimirMedicion(Nombre, M);
+}
+
+static void MedirTipos()
+{
+   pid_config_s Config = ConfiguracionPrueba(Estructuras[2], Limites[2]);
+   for (int Jitter=0; Jitter<2; Jitter++) {
+      printf(Jitter ? "Periodo medido con jitter de +-50 us\n" : "Periodo medido constante\n");
+      MedirTipo<float>  ("float",   Config, Jitter);
+      MedirTipo<double> ("double",  Config, Jitter);
+      MedirTipo<fijoQ16>("fijoQ16", Config, Jitter);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+struct sintoniaPI  { static constexpr float Kp = 5, Ti = 4, Td = 0,    LimiteSuperior = 20, LimiteInferior = 0; };
+struct sintoniaPID { static constexpr float Kp = 5, Ti = 4, Td = 0.5f, LimiteSuperior = 20, LimiteInferior = 0; };
+
+// Mide un controlador con PeriodoFijo(PERIODO_US) y verifica que dé las mismas salidas que
+// controlPID con la misma configuración.
+template <class C>
+static void MedirFijo(const char * NOMBRE, C & PID, pid_config_s CONFIG)
+{
+   controlPID Referencia(PID_SIN_SALIDA);
+   bool       Identicos = true;
+   char       Nombre[64];
+   
+   Referencia.PeriodoFijo(PERIODO_US);
+   Referencia.Configurar(&CONFIG);
+   PID.Configurar(&CONFIG);
+   for (int i=0; i<100000; i++) {
+      float M = Mediciones[i & (MUESTRAS-1)];
+      Identicos = Identicos && ( Referencia.Controlar(M) == PID.Controlar(M) );
+   }
+   PID.Configurar(&CONFIG);
+   medicion_s R = Medir([&](unsigned long i) {
+      Sumidero = PID.Controlar(Mediciones[i & (MUESTRAS-1)]);
+   }, ITERACIONES);
+   snprintf(Nombre, sizeof(Nombre), "%s (%s)", NOMBRE, Identicos ? "identico" : "DIFIERE");
+   Diferencias = Diferencias || !Identicos;
+   ImprimirMedicion(Nombre, R);
+}
+
+static void MedirEspecializados()
+{
+   for (int e=1; e<3; e++) {
+      pid_config_s Config = ConfiguracionPrueba(Estructuras[e], Limites[2]);
+      controlPID   Dinamico(PIN_PWM);
+      Dinamico.PeriodoFijo(PERIODO_US);
+      MedirFijo(e==1 ? "PI  controlPID" : "PID controlPID", Dinamico, Config);
+      if (e==1) {
+         controlPIDFijo<PID_ESTRUCTURA_PI | PID_LIMITAR | PID_ANTIENROLE, PIN_PWM, PERIODO_US> F;
+         controlPIDFijo<PID_ESTRUCTURA_PI | PID_LIMITAR | PID_ANTIENROLE, PIN_PWM, PERIODO_US,
+                        sintoniaPI> S;
+         MedirFijo("PI  estructura fija", F, Config);
+         MedirFijo("PI  estructura y sintonia fijas", S, Config);
+      } else {
+         controlPIDFijo<PID_ESTRUCTURA_PID | PID_LIMITAR | PID_ANTIENROLE, PIN_PWM, PERIODO_US> F;
+         controlPIDFijo<PID_ESTRUCTURA_PID | PID_LIMITAR | PID_ANTIENROLE, PIN_PWM, PERIODO_US,
+                        sintoniaPID> S;
+         MedirFijo("PID estructura fija", F, Config);
+         MedirFijo("PID estructura y sintonia fijas", S, Config);
+      }
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static unsigned long MuestraCascada;       // Índice de medición para las funciones de grafoPID
+
+static float MedirExterno() { return Mediciones[MuestraCascada & (MUESTRAS-1)]; }
+static float MedirInterno() { return Mediciones[(MuestraCascada + 17) & (MUESTRAS-1)] - 5; }
+
+static void MedirCascada()
+{
+   pid_config_s Externa = ConfiguracionPrueba(Estructuras[1], Limites[2]);
+   pid_config_s Interna = ConfiguracionPrueba(Estructuras[2], Limites[2]);
+   controlPID   Ext(PID_SIN_SALIDA), Int(PIN_PWM), GExt(PID_SIN_SALIDA), GInt(PIN_PWM);
+   grafoPID     Grafo(PERIODO_US);
+   bool         Identicos = true;
+   char         Nombre[64];
+   
+   Ext.PeriodoFijo(PERIODO_US);
+   Int.PeriodoFijo(PERIODO_US);
+   Ext.Configurar(&Externa);
+   Int.Configurar(&Interna);
+   uint8_t E = Grafo.Agregar(&GExt, MedirExterno, 0, 1);
+   uint8_t I = Grafo.Agregar(&GInt, MedirInterno, 0, 1);
+   Grafo.Consigna(E, I, 1);
+   GExt.Configurar(&Externa);
+   GInt.Configurar(&Interna);
+   for (MuestraCascada=0; MuestraCascada<100000; MuestraCascada++) {
+      float Salida = Int.Controlar(MedirInterno(), Ext.Controlar(MedirExterno()));
+      Grafo.Ejecutar();
+      Identicos = Identicos && (Salida == Grafo.Salida(I));
+   }
+   
+   medicion_s M = Medir([&](unsigned long i) {
+      MuestraCascada = i;
+      Sumidero = Int.Controlar(MedirInterno(), Ext.Controlar(MedirExterno()));
+   }, ITERACIONES);
+   ImprimirMedicion("a mano", M);
+   M = Medir([&](unsigned long i) {
+      MuestraCascada = i;
+      Grafo.Ejecutar();
+      Sumidero = Grafo.Salida(I);
+   }, ITERACIONES);
+   snprintf(Nombre, sizeof(Nombre), "grafoPID con MEDIR (%s)", Identicos ? "identico" : "DIFIERE");
+   Diferencias = Diferencias || !Identicos;
+   ImprimirMedicion(Nombre, M);
+   M = Medir([&](unsigned long i) {
+      MuestraCascada = i;
+      float Entradas[2] = { MedirExterno(), MedirInterno() };
+      Grafo.Ejecutar(Entradas);
+      Sumidero = Grafo.Salida(I);
+   }, ITERACIONES);
+   ImprimirMedicion("grafoPID con arreglo de mediciones", M);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static void MedirProgramado()
+// Con ganancias iguales en toda la tabla debe dar lo mismo que controlPID; con ganancias
+// distintas se mide el costo de la interpolación (la medición recorre varias celdas).
+{
+   static const pid_ganancias_s Constante[] = { { 5, 5, 4, 0.5f }, { 15, 5, 4, 0.5f } };
+   static const pid_ganancias_s Variable[]  = { {  5, 8, 6, 0.8f }, { 9, 5,  4, 0.5f },
+                                                { 12, 3, 2, 0.2f }, {15, 2,  0, 0    } };
+   pid_config_s         Config = ConfiguracionPrueba(Estructuras[2], Limites[2]);
+   controlPID           Referencia(PIN_PWM);
+   controlPIDProgramado Igual(PIN_PWM), Programado(PIN_PWM);
+
+   Referencia.PeriodoFijo(PERIODO_US);
+   MedirFijo("PID controlPID", Referencia, Config);
+   Igual.PeriodoFijo(PERIODO_US);
+   Igual.Programar(Constante, 2, PID_PROGRAMA_MEDICION);
+   MedirFijo("PID tabla constante", Igual, Config);
+   Programado.PeriodoFijo(PERIODO_US);
+   Programado.Programar(Variable, 4, PID_PROGRAMA_MEDICION);
+   Programado.Configurar(&Config);
+   medicion_s M = Medir([&](unsigned long i) {
+      Sumidero = Programado.Controlar(Mediciones[i & (MUESTRAS-1)]);
+   }, ITERACIONES);
+   ImprimirMedicion("PID tabla de 4 puntos por medicion", M);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static void MedirSalidaPWM()
+// La escritura se omite cuando el ciclo de trabajo no cambia: con mediciones ruidosas casi
+// todas las muestras escriben; con el lazo estabilizado, casi ninguna.
+{
+   pid_config_s      Config = ConfiguracionPrueba(Estructuras[1], Limites[2]);
+   volatile uint16_t Registro;
+   char              Nombre[64];
+   
+   for (int Caso=0; Caso<3; Caso++) {
+      static const char * const Nombres[] = { "sin salida", "analogWrite", "registro" };
+      controlPID PID(Caso == 0 ? PID_SIN_SALIDA : PIN_PWM);
+      PID.PeriodoFijo(PERIODO_US);
+      PID.Configurar(&Config);
+      if (Caso == 2) {
+         PID.RegistroPWM(&Registro);
+      }
+      unsigned long Antes = EscriturasPWM;
+      medicion_s M = Medir([&](unsigned long i) {
+         Sumidero = PID.Controlar(Mediciones[i & (MUESTRAS-1)]);
+      }, ITERACIONES);
+      snprintf(Nombre, sizeof(Nombre), "PI %s", Nombres[Caso]);
+      ImprimirMedicion(Nombre, M);
+      if (Caso == 1) {
+         printf("   analogWrite por muestra, mediciones con ruido %9.3f\n",
+                double(EscriturasPWM - Antes) / (ITERACIONES + ITERACIONES/16));
+         Antes = EscriturasPWM;
+         for (unsigned long i=0; i<ITERACIONES; i++) PID.Controlar(Config.Objetivo);
+         printf("   analogWrite por muestra, medicion estable    %9.3f\n",
+                double(EscriturasPWM - Antes) / ITERACIONES);
+      }
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+#define LECTURAS_POR_PERIODO 64
+#define CUENTAS_POR_VOLT     (1023.0f / 5)
+
+static void MedirEntrada()
+// Costo por lectura (Agregar desde la "interrupción" más la parte del filtro) y lazo cerrado
+// contra una planta de primer orden con un sensor de 0 a 5 V y ruido uniforme de ±20 cuentas:
+// sin filtro el PID recibe la última lectura del período; con filtro, la salida de entradaPID.
+{
+   static uint16_t Lecturas[MUESTRAS];
+   for (int i=0; i<MUESTRAS; i++) {
+      Lecturas[i] = uint16_t(Mediciones[i] * 50);
+   }
+   static const char * const Nombres[] = { "sin filtro", "CIC orden 1 (promedio)",
+                                            "CIC orden 3", "IIR corrimiento 4" };
+   for (int Caso=0; Caso<4; Caso++) {
+      entradaPID Entrada;
+      if (Caso == 1) Entrada.Promediar(1, LECTURAS_POR_PERIODO);
+      if (Caso == 2) Entrada.Promediar(3, LECTURAS_POR_PERIODO);
+      if (Caso == 3) Entrada.Suavizar(4);
+      medicion_s M = Medir([&](unsigned long i) {
+         Entrada.Agregar(Lecturas[i & (MUESTRAS-1)]);
+         if ((i & (LECTURAS_POR_PERIODO-1)) == LECTURAS_POR_PERIODO-1) {
+            Sumidero = Entrada.Medicion();
+         }
+      }, ITERACIONES);
+      char Nombre[64];
+      snprintf(Nombre, sizeof(Nombre), "por lectura, %s", Nombres[Caso]);
+      ImprimirMedicion(Nombre, M);
+   }
+
+   printf("   Lazo con sensor ruidoso, %d lecturas por periodo de 10 ms:\n",
+          LECTURAS_POR_PERIODO);
+   for (int Caso=0; Caso<4; Caso++) {
+      pid_config_s Config = {};
+      Config.Kp = 2;  Config.Ti = 0.5f;  Config.Td = 0.05f;
+      Config.LimiteSuperior = 5;  Config.CompensarIntegral = true;
+      Config.Objetivo = 2.5f;
+      controlPID        PID;
+      entradaPID        Entrada;
+      plantaPrimerOrden Planta(1, 0.5f, 0);
+      PID.PeriodoFijo(10000);
+      PID.Configurar(&Config);
+      if (Caso == 1) Entrada.Promediar(1, LECTURAS_POR_PERIODO);
+      if (Caso == 2) Entrada.Promediar(3, LECTURAS_POR_PERIODO);
+      if (Caso == 3) Entrada.Suavizar(4);
+      Entrada.Escalar(1 / CUENTAS_POR_VOLT, 0);
+      srand(2);
+      float  Salida = 0, SalidaAnterior = 0, Medicion = 0;
+      double Chasquido = 0, Error = 0;
+      int    Contadas = 0;
+      for (int k=0; k<3000; k++) {
+         for (int j=0; j<LECTURAS_POR_PERIODO; j++) {
+            float Y = Planta.Simular(Salida, 10000 / LECTURAS_POR_PERIODO);
+            int   L = int(Y * CUENTAS_POR_VOLT + 0.5f) + rand() % 41 - 20;
+            L = max(0, min(1023, L));
+            if (Caso == 0) {
+               Medicion = L / CUENTAS_POR_VOLT;
+            } else {
+               Entrada.Agregar(uint16_t(L));
+            }
+         }
+         if (Caso != 0) {
+            Medicion = Entrada.Medicion();
+         }
+         Salida = PID.Controlar(Medicion);
+         if (k >= 500) {                  // Después del transitorio
+            Chasquido += double(Salida - SalidaAnterior) * (Salida - SalidaAnterior);
+            Error     += double(Planta.Salida() - Config.Objetivo)
+                       * (Planta.Salida() - Config.Objetivo);
+            Contadas++;
+         }
+         SalidaAnterior = Salida;
+      }
+      printf("   %-24s variacion RMS de la salida %7.4f V   error RMS de la planta %7.4f V\n",
+             Nombres[Caso], sqrt(Chasquido / Contadas), sqrt(Error / Contadas));
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int main()
+{
+   // Mediciones alrededor del objetivo con algo de ruido, reproducibles:
+   srand(1);
+   for (int i=0; i<MUESTRAS; i++) {
+      Mediciones[i] = 10 + 3*sinf(i*0.05f) + (rand()%1000)*0.001f;
+   }
+   
+   printf("controlPID: %zu bytes (presupuesto %zu)\n", sizeof(controlPID), 
+          size_t(PID_PRESUPUESTO_BYTES));
+   printf("controlPID::Controlar() - %lu iteraciones por caso\n", ITERACIONES);
+   MedirControlar();
+   printf("\nPeriodo medido con micros() contra PeriodoFijo()\n");
+   MedirPeriodoFijo();
+   printf("\nBanco de N lazos (ancho vectorial %d), costo por lazo\n", PID_BANCO_ANCHO);
+   MedirBancos();
+   printf("\nPID con limites+compens, por tipo numerico (referencia: double)\n");
+   MedirTipos();
+   printf("\nEstructura fijada al compilar (controlPIDFijo), periodo fijo, limites+compens\n");
+   MedirEspecializados();
+   printf("\nCascada PI externo -> PID interno, costo por periodo\n");
+   MedirCascada();
+   printf("\nGanancias programadas (controlPIDProgramado), periodo fijo, limites+compens\n");
+   MedirProgramado();
+   printf("\nEtapa de salida PWM (%d bits), periodo fijo, limites+compens\n", PID_PWM_BITS);
+   MedirSalidaPWM();
+   printf("\nEtapa de entrada (entradaPID), %d lecturas por medicion\n", LECTURAS_POR_PERIODO);
+   MedirEntrada();
+   if (Diferencias) {
+      printf("\nFALLA: alguna variante no dio salidas identicas a controlPID\n");
+      return 1;
+   }
+   return 0;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/benchmark_pid.cpp
+**************************************************************************************************/
@@ -0,0 +1,73 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/decodificar_telemetria.cpp
+* Breve:      Convierte a CSV la telemetría binaria de telemetriaPID (ver
+*             control-pid-telemetria_sca.h). Lee de un archivo o de la entrada estándar (por
+*             ejemplo, el puerto serie ya configurado), se resincroniza ante bytes inválidos y
+*             avisa por stderr las tramas con CRC erróneo y los saltos de secuencia.
+* Uso:        decodificar_telemetria [ARCHIVO] > datos.csv
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid-telemetria_sca.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int main(int argc, char ** argv)
+{
+   FILE * Entrada = (argc > 1) ? fopen(argv[1], "rb") : stdin;
+   uint8_t Trama[TELEMETRIA_TRAMA];
+   size_t  Largo = 0;
+   unsigned long Tramas = 0, Erroneas = 0, Saltos = 0;
+   int     SecuenciaEsperada = -1;
+   
+   if (!Entrada) {
+      fprintf(stderr, "No se pudo abrir %s\n", argv[1]);
+      return 1;
+   }
+   printf("Tiempo,Salida,ComponenteProporcional,ComponenteIntegral,ComponenteDerivativo,"
+          "Compensacion,UltimaMedicion,LimitarSalida\n");
+   
+   int c;
+   while ((c = fgetc(Entrada)) != EOF) {
+      Trama[Largo++] = uint8_t(c);
+      // Espera el sincronismo byte a byte
+      if (Largo == 1 && Trama[0] != TELEMETRIA_SINCRONISMO_1) { Largo = 0; continue; }
+      if (Largo == 2 && Trama[1] != TELEMETRIA_SINCRONISMO_2) {
+         Largo = (Trama[1] == TELEMETRIA_SINCRONISMO_1) ? 1 : 0;
+         Trama[0] = Trama[1];
+         continue;
+      }
+      if (Largo < TELEMETRIA_TRAMA) continue;
+      
+      uint8_t        Secuencia;
+      pid_registro_s R;
+      if (!LeerTramaTelemetria(Trama, &Secuencia, &R)) {
+         // Trama inválida: se busca el próximo sincronismo dentro de lo ya leído
+         Erroneas++;
+         size_t i = 1;
+         while (i < Largo && Trama[i] != TELEMETRIA_SINCRONISMO_1) i++;
+         memmove(Trama, &Trama[i], Largo-i);
+         Largo -= i;
+         continue;
+      }
+      Largo = 0;
+      Tramas++;
+      if (SecuenciaEsperada >= 0 && Secuencia != SecuenciaEsperada) Saltos++;
+      SecuenciaEsperada = uint8_t(Secuencia + 1);
+      printf("%lu,%g,%g,%g,%g,%g,%g,%d\n", R.Tiempo, R.Info.Salida, 
+             R.Info.ComponenteProporcional, R.Info.ComponenteIntegral, 
+             R.Info.ComponenteDerivativo, R.Info.Compensacion, R.Info.UltimaMedicion, 
+             R.Info.LimitarSalida);
+   }
+   fprintf(stderr, "%lu tramas, %lu con error, %lu saltos de secuencia\n", Tramas, Erroneas, Saltos);
+   if (Entrada != stdin) fclose(Entrada);
+   return 0;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/decodificar_telemetria.cpp
+**************************************************************************************************/
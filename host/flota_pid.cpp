@@ -0,0 +1,304 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/flota_pid.cpp
+* Breve:      Implementación de la ejecución de flotas de controlPID. Ver host/flota_pid.h.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "flota_pid.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+static uint64_t Nanosegundos()
+{
+   struct timespec T;
+   clock_gettime(CLOCK_MONOTONIC, &T);
+   return uint64_t(T.tv_sec) * 1000000000ULL + T.tv_nsec;
+}
+
+static void DormirHasta(uint64_t INSTANTE)
+{
+   struct timespec T;
+   T.tv_sec  = INSTANTE / 1000000000ULL;
+   T.tv_nsec = INSTANTE % 1000000000ULL;
+   while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &T, NULL) != 0) {}
+}
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+flotaPID::flotaPID()
+{
+   Opciones  = {};
+   Terminar  = false;
+   Encoladas = 0;
+   Turno     = 0;
+   Inicio    = 0;
+}
+
+flotaPID::~flotaPID()
+{
+   Detener();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int flotaPID::Agregar(controlPID * PID, flota_medir_t MEDIR, flota_actuar_t ACTUAR,
+                      void * CONTEXTO, unsigned long PERIODO)
+{
+   if (!Hilos.empty() || PERIODO == 0) {
+      return FLOTA_LLENA;
+   }
+   unsigned int g = 0;
+   while (g < Grupos.size() && Grupos[g]->Periodo != PERIODO) g++;
+   if (g == Grupos.size()) {
+      Grupos.emplace_back(new grupo_s);
+      grupo_s * G = Grupos.back().get();
+      G->Periodo         = PERIODO;
+      G->Proxima         = 0;
+      G->Liberacion      = 0;
+      G->Pendientes      = 0;
+      G->EnCurso         = false;
+      G->Liberaciones    = 0;
+      G->Vencidos        = 0;
+      G->Omitidos        = 0;
+      G->RespuestaMaxima = 0;
+      G->LazosEjecutados = 0;
+   }
+   PID->PeriodoFijo(PERIODO);
+   Grupos[g]->Lazos.push_back( lazo_s{PID, MEDIR, ACTUAR, CONTEXTO} );
+   return g;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool flotaPID::Iniciar(const flota_opciones_s * OPCIONES)
+{
+   bool Bien = true;
+
+   Detener();
+   Opciones = *OPCIONES;
+   if (Opciones.Hilos == 0) Opciones.Hilos = std::thread::hardware_concurrency();
+   if (Opciones.Hilos == 0) Opciones.Hilos = 1;
+   if (Opciones.Tick == 0)  Opciones.Tick  = 100;
+
+   Terminar  = false;
+   Encoladas = 0;
+   Colas.clear();
+   for (unsigned int h=0; h<Opciones.Hilos; h++) Colas.emplace_back(new cola_s);
+   for (unsigned int r=0; r<FLOTA_RANURAS; r++) Rueda[r].clear();
+   for (std::unique_ptr<grupo_s> & G : Grupos) {
+      G->Proxima = 0;                     // Todos los grupos arrancan en el tick 0
+      G->EnCurso = false;
+      Rueda[0].push_back(G.get());
+   }
+
+   Inicio = Nanosegundos();
+   for (unsigned int h=0; h<Opciones.Hilos; h++) {
+      Hilos.emplace_back(&flotaPID::Trabajar, this, h);
+      Bien = AplicarOpciones(Hilos.back(), h) && Bien;
+   }
+   if (Opciones.Libre) {
+      for (std::unique_ptr<grupo_s> & G : Grupos) Liberar(G.get(), Inicio);
+   } else {
+      Despachador = std::thread(&flotaPID::Despachar, this);
+      Bien = AplicarOpciones(Despachador, Opciones.Hilos) && Bien;
+   }
+   return Bien;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void flotaPID::Detener()
+{
+   Terminar = true;
+   {
+      std::lock_guard<std::mutex> Bloqueo(CerrojoEspera);
+   }
+   Espera.notify_all();
+   if (Despachador.joinable()) Despachador.join();
+   for (std::thread & H : Hilos) H.join();
+   Hilos.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned int flotaPID::CantidadGrupos()
+{
+   return Grupos.size();
+}
+
+unsigned int flotaPID::CantidadHilos()
+{
+   return Opciones.Hilos;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void flotaPID::Leer(unsigned int GRUPO, flota_grupo_info_s * INFO)
+{
+   const grupo_s * G = Grupos[GRUPO].get();
+   INFO->Periodo         = G->Periodo;
+   INFO->Lazos           = G->Lazos.size();
+   INFO->Liberaciones    = G->Liberaciones;
+   INFO->Vencidos        = G->Vencidos;
+   INFO->Omitidos        = G->Omitidos;
+   INFO->RespuestaMaxima = G->RespuestaMaxima;
+   INFO->LazosEjecutados = G->LazosEjecutados;
+}
+
+/**************************************************************************************************
+* Funciones privadas
+**************************************************************************************************/
+
+void flotaPID::Despachar()
+// Rueda de tiempo: en cada tick se recorre sólo su ranura; los grupos cuya liberación cae en
+// una vuelta posterior quedan en la ranura hasta que Proxima coincide con el tick.
+{
+   uint64_t TickNs = uint64_t(Opciones.Tick) * 1000;
+   uint64_t Tick   = 0;
+
+   while (!Terminar) {
+      uint64_t Instante = Inicio + Tick * TickNs;
+      DormirHasta(Instante);
+      std::vector<grupo_s *> & Ranura = Rueda[Tick % FLOTA_RANURAS];
+      size_t i = 0;
+      while (i < Ranura.size()) {
+         grupo_s * G = Ranura[i];
+         if (G->Proxima != Tick) {
+            i++;
+            continue;
+         }
+         Ranura[i] = Ranura.back();
+         Ranura.pop_back();
+         Liberar(G, Instante);
+         unsigned long Paso = (G->Periodo + Opciones.Tick/2) / Opciones.Tick;
+         G->Proxima = Tick + (Paso > 0 ? Paso : 1);
+         Rueda[G->Proxima % FLOTA_RANURAS].push_back(G);
+      }
+      Tick++;
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void flotaPID::Liberar(grupo_s * GRUPO, uint64_t INSTANTE)
+// Divide el grupo en tareas de FLOTA_BLOQUE_LAZOS lazos y las reparte entre las colas.
+{
+   bool Libre = false;
+   if (!GRUPO->EnCurso.compare_exchange_strong(Libre, true)) {
+      GRUPO->Omitidos++;
+      return;
+   }
+   unsigned int Cantidad = GRUPO->Lazos.size();
+   GRUPO->Liberacion = INSTANTE;
+   GRUPO->Liberaciones++;
+   GRUPO->Pendientes = (Cantidad + FLOTA_BLOQUE_LAZOS - 1) / FLOTA_BLOQUE_LAZOS;
+   for (unsigned int Primero=0; Primero<Cantidad; Primero+=FLOTA_BLOQUE_LAZOS) {
+      tarea_s T = { GRUPO, Primero, min(Primero + FLOTA_BLOQUE_LAZOS, Cantidad) };
+      cola_s & C = *Colas[Turno++ % Colas.size()];
+      Encoladas++;
+      std::lock_guard<std::mutex> Bloqueo(C.Cerrojo);
+      C.Tareas.push_back(T);
+   }
+   {
+      std::lock_guard<std::mutex> Bloqueo(CerrojoEspera);
+   }
+   Espera.notify_all();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool flotaPID::Tomar(unsigned int HILO, tarea_s * TAREA)
+// Primero la cola propia (la tarea más reciente) y si está vacía roba la más antigua de otra.
+{
+   unsigned int Cantidad = Colas.size();
+   for (unsigned int k=0; k<Cantidad; k++) {
+      cola_s & C = *Colas[(HILO + k) % Cantidad];
+      std::lock_guard<std::mutex> Bloqueo(C.Cerrojo);
+      if (C.Tareas.empty()) continue;
+      if (k == 0) {
+         *TAREA = C.Tareas.back();
+         C.Tareas.pop_back();
+      } else {
+         *TAREA = C.Tareas.front();
+         C.Tareas.pop_front();
+      }
+      Encoladas--;
+      return true;
+   }
+   return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void flotaPID::Ejecutar(const tarea_s * TAREA)
+{
+   grupo_s * G = TAREA->Grupo;
+   for (unsigned int i=TAREA->Inicio; i<TAREA->Fin; i++) {
+      const lazo_s & L = G->Lazos[i];
+      L.Actuar(L.Contexto, L.PID->Controlar( L.Medir(L.Contexto) ));
+   }
+   if (G->Pendientes.fetch_sub(1) != 1) {
+      return;
+   }
+   // Última tarea de la liberación:
+   uint64_t      Ahora     = Nanosegundos();
+   unsigned long Respuesta = (Ahora - G->Liberacion) / 1000;
+   unsigned long Maxima    = G->RespuestaMaxima;
+   if (Respuesta > G->Periodo) {
+      G->Vencidos++;
+   }
+   while (Respuesta > Maxima && !G->RespuestaMaxima.compare_exchange_weak(Maxima, Respuesta)) {}
+   G->LazosEjecutados += G->Lazos.size();
+   G->EnCurso = false;
+   if (Opciones.Libre && !Terminar) {
+      Liberar(G, Ahora);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void flotaPID::Trabajar(unsigned int HILO)
+{
+   tarea_s T;
+   while (true) {
+      if (Tomar(HILO, &T)) {
+         Ejecutar(&T);
+         continue;
+      }
+      std::unique_lock<std::mutex> Bloqueo(CerrojoEspera);
+      Espera.wait(Bloqueo, [this] { return Encoladas > 0 || Terminar; });
+      if (Terminar && Encoladas == 0) {
+         return;
+      }
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool flotaPID::AplicarOpciones(std::thread & HILO, unsigned int NUCLEO)
+{
+   bool Bien = true;
+   if (Opciones.Afinidad) {
+      unsigned int Nucleos = std::thread::hardware_concurrency();
+      cpu_set_t    Conjunto;
+      CPU_ZERO(&Conjunto);
+      CPU_SET(NUCLEO % (Nucleos > 0 ? Nucleos : 1), &Conjunto);
+      Bien = pthread_setaffinity_np(HILO.native_handle(), sizeof(Conjunto), &Conjunto) == 0;
+   }
+   if (Opciones.PrioridadFIFO > 0) {
+      struct sched_param Parametro = {};
+      Parametro.sched_priority = Opciones.PrioridadFIFO;
+      Bien = pthread_setschedparam(HILO.native_handle(), SCHED_FIFO, &Parametro) == 0 && Bien;
+   }
+   return Bien;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/flota_pid.cpp
+**************************************************************************************************/
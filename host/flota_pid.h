@@ -0,0 +1,126 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/flota_pid.h
+* Breve:      Ejecución de miles de controlPID en Linux (por ejemplo en un gateway), sin escribir
+*             un lazo de tiempo para cada uno. Los lazos se agrupan por período; una rueda de
+*             tiempo (timing wheel) libera cada grupo en su instante y un conjunto de hilos con
+*             robo de trabajo (work stealing) reparte los lazos del grupo en bloques. Opcionalmente
+*             fija cada hilo a un núcleo y usa SCHED_FIFO. Por grupo informa liberaciones, plazos
+*             vencidos (terminó después de la liberación siguiente), liberaciones omitidas (la
+*             anterior seguía en curso) y tiempo de respuesta máximo.
+*             Cada controlPID se pone en PeriodoFijo() con el período de su grupo.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef FLOTA_PID_H
+#define FLOTA_PID_H
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define FLOTA_RANURAS       256           // Ranuras de la rueda de tiempo
+#define FLOTA_BLOQUE_LAZOS  64            // Lazos por tarea
+#define FLOTA_LLENA         -1            // Agregar() después de Iniciar()
+
+typedef float (*flota_medir_t)(void * CONTEXTO);
+typedef void  (*flota_actuar_t)(void * CONTEXTO, float SALIDA);
+
+struct flota_opciones_s {
+   unsigned int  Hilos;                   // Hilos de trabajo (0: uno por núcleo)
+   bool          Afinidad;                // Fija el hilo i al núcleo i (módulo núcleos)
+   int           PrioridadFIFO;           // >0: SCHED_FIFO con esa prioridad (requiere permisos)
+   unsigned long Tick;                    // Resolución de la rueda en microsegundos (0: 100)
+   bool          Libre;                   // Sin reloj: cada grupo se vuelve a liberar apenas
+                                          // termina. Sirve para medir la capacidad.
+};
+
+struct flota_grupo_info_s {
+   unsigned long Periodo;                 // En microsegundos
+   unsigned int  Lazos;
+   unsigned long Liberaciones;
+   unsigned long Vencidos;                // Liberaciones terminadas después de su plazo
+   unsigned long Omitidos;                // Liberaciones saltadas: la anterior no había terminado
+   unsigned long RespuestaMaxima;         // Desde el instante nominal de liberación, en us
+   unsigned long LazosEjecutados;
+};
+
+class flotaPID
+{
+   private:
+   struct lazo_s {
+      controlPID *   PID;
+      flota_medir_t  Medir;
+      flota_actuar_t Actuar;
+      void *         Contexto;
+   };
+   struct grupo_s {
+      unsigned long              Periodo;
+      std::vector<lazo_s>        Lazos;
+      uint64_t                   Proxima;     // Tick de la próxima liberación
+      uint64_t                   Liberacion;  // Instante nominal de la liberación en curso (ns)
+      std::atomic<unsigned int>  Pendientes;  // Tareas sin terminar de la liberación en curso
+      std::atomic<bool>          EnCurso;
+      std::atomic<unsigned long> Liberaciones;
+      std::atomic<unsigned long> Vencidos;
+      std::atomic<unsigned long> Omitidos;
+      std::atomic<unsigned long> RespuestaMaxima;
+      std::atomic<unsigned long> LazosEjecutados;
+   };
+   struct tarea_s {
+      grupo_s *    Grupo;
+      unsigned int Inicio;
+      unsigned int Fin;
+   };
+   struct cola_s {                        // Cola de un hilo: el dueño toma del final y los
+      std::mutex          Cerrojo;        // demás roban del principio.
+      std::deque<tarea_s> Tareas;
+   };
+
+   std::vector<std::unique_ptr<grupo_s>> Grupos;
+   std::vector<std::unique_ptr<cola_s>>  Colas;
+   std::vector<std::thread>              Hilos;
+   std::thread                           Despachador;
+   std::vector<grupo_s *>                Rueda[FLOTA_RANURAS];
+   flota_opciones_s                      Opciones;
+   std::atomic<bool>                     Terminar;
+   std::atomic<unsigned int>             Encoladas;     // Tareas en todas las colas
+   std::atomic<unsigned int>             Turno;         // Reparto de tareas entre colas
+   std::mutex                            CerrojoEspera;
+   std::condition_variable               Espera;
+   uint64_t                              Inicio;        // Instante del tick 0 (ns)
+
+   void Liberar(grupo_s * GRUPO, uint64_t INSTANTE);
+   bool Tomar(unsigned int HILO, tarea_s * TAREA);
+   void Ejecutar(const tarea_s * TAREA);
+   void Trabajar(unsigned int HILO);
+   void Despachar();
+   bool AplicarOpciones(std::thread & HILO, unsigned int NUCLEO);
+
+   public:
+   flotaPID();
+   ~flotaPID();
+   int Agregar(controlPID * PID, flota_medir_t MEDIR, flota_actuar_t ACTUAR, void * CONTEXTO,
+               unsigned long PERIODO);
+                                          // Agrega un lazo al grupo de PERIODO (en us) y devuelve
+                                          // el número de grupo, o FLOTA_LLENA si ya se inició.
+   bool Iniciar(const flota_opciones_s * OPCIONES);
+                                          // Lanza los hilos. Devuelve false si no se pudo aplicar
+                                          // la afinidad o SCHED_FIFO (igual se ejecuta).
+   void Detener();                        // Espera a que terminen las tareas en curso.
+   unsigned int CantidadGrupos();
+   unsigned int CantidadHilos();
+   void Leer(unsigned int GRUPO, flota_grupo_info_s * INFO);
+};
+
+#endif // FLOTA_PID_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
@@ -0,0 +1,370 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/frecuencia_pid.cpp
+* Breve:      Implementación del análisis en frecuencia. Ver host/frecuencia_pid.h.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "frecuencia_pid.h"
+#include "medicion.h"
+
+#include <atomic>
+#include <complex>
+#include <math.h>
+#include <thread>
+#include <vector>
+
+typedef std::complex<double> complejo;
+
+struct tono_s {
+   long   Bin;                            // Ciclos enteros en la ventana
+   double Amplitud;
+   double Fase;                           // Radianes
+};
+
+struct fourier_s {                        // Componentes en la frecuencia de un tono
+   complejo U, C, Y, D;
+};
+
+analisis_frecuencia_s AnalisisPredeterminado()
+{
+   analisis_frecuencia_s A;
+   A.Planta       = SimulacionPredeterminada();
+   A.Desde        = 1 / (1000 * A.Planta.Tau);
+   A.Hasta        = 0.45e6 / A.Planta.Periodo;
+   A.Puntos       = 40;
+   A.Amplitud     = 0;                    // 0: 1% del rango de la salida (o 0,01)
+   A.Asentamiento = 0;                    // 0: 20 * (Tau + Retardo) + 200 periodos
+   A.Ciclos       = 4;
+   A.Multiseno    = false;
+   return A;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static double Asentamiento(const analisis_frecuencia_s * A)
+{
+   if (A->Asentamiento > 0) {
+      return A->Asentamiento;
+   }
+   return 20 * (A->Planta.Tau + A->Planta.Retardo) + 200 * A->Planta.Periodo / 1e6;
+}
+
+static double Amplitud(const pid_config_s * CONFIG, const analisis_frecuencia_s * A)
+{
+   if (A->Amplitud > 0) {
+      return A->Amplitud;
+   }
+   double Rango = fabs(CONFIG->LimiteSuperior - CONFIG->LimiteInferior);
+   return (Rango > 0) ? 0.01 * Rango : 0.01;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static bool Inyectar(const pid_config_s * CONFIG, const analisis_frecuencia_s * A,
+                     const tono_s * TONOS, unsigned int K, long VENTANA, fourier_s * F,
+                     double * DISTORSION)
+// Asienta el lazo, inyecta la suma de tonos durante un transitorio (al menos una ventana) y
+// acumula las componentes de U y de la medición en la ventana siguiente. Los fasores de cada
+// tono se rotan en cada muestra (sin senos por muestra) y se renormalizan cada tanto.
+{
+   const simulacion_s * SIM = &A->Planta;
+   pid_config_s Config = *CONFIG;
+   controlPID   PID(PID_SIN_SALIDA);
+
+   plantaPrimerOrden        PrimerOrden(SIM->Ganancia, SIM->Tau, SIM->Inicial);
+   plantaPrimerOrdenRetardo ConRetardo(SIM->Ganancia, SIM->Tau, SIM->Retardo, SIM->Inicial);
+   plantaSegundoOrden       SegundoOrden(SIM->Ganancia, 1 / SIM->Tau, SIM->Zeta, SIM->Inicial);
+   planta * Planta = &PrimerOrden;
+   if (SIM->Modelo == MODELO_RETARDO)       Planta = &ConRetardo;
+   if (SIM->Modelo == MODELO_SEGUNDO_ORDEN) Planta = &SegundoOrden;
+
+   Config.Objetivo = SIM->Objetivo;
+   PID.PeriodoFijo(SIM->Periodo);
+   PID.Configurar(&Config);
+
+   double T        = SIM->Periodo / 1e6;
+   long   Asentar  = long(Asentamiento(A) / T);
+   long   Previas  = std::max(VENTANA, long(Asentamiento(A) / 2 / T));
+   float  Medicion = SIM->Inicial;
+   for (long k=0; k<Asentar; k++) {
+      Medicion = Planta->Simular(PID.Controlar(Medicion), SIM->Periodo);
+   }
+
+   std::vector<complejo> Fasor(K), Paso(K), Inicio(K);
+   for (unsigned int i=0; i<K; i++) {
+      double W = 2 * M_PI * TONOS[i].Bin / VENTANA;
+      Paso[i]   = std::polar(1.0, W);
+      Fasor[i]  = 1;
+      Inicio[i] = std::polar(TONOS[i].Amplitud, TONOS[i].Fase);
+      F[i]      = fourier_s();
+   }
+   double SumaU = 0, SumaUU = 0;
+   for (long k=0; k<Previas+VENTANA; k++) {
+      double D = 0;
+      for (unsigned int i=0; i<K; i++) {
+         D += (Fasor[i] * Inicio[i]).imag();
+      }
+      double U = PID.Controlar(Medicion) + D;
+      if (k >= Previas) {
+         for (unsigned int i=0; i<K; i++) {
+            complejo E = std::conj(Fasor[i]);
+            F[i].U += U * E;
+            F[i].Y += double(Medicion) * E;
+         }
+         SumaU  += U;
+         SumaUU += U * U;
+      }
+      Medicion = Planta->Simular(float(U), SIM->Periodo);
+      if (!(fabsf(Medicion) < 1e12f)) {
+         *DISTORSION = 1;                 // Divergió (o NaN): lazo inestable
+         return false;
+      }
+      for (unsigned int i=0; i<K; i++) {
+         Fasor[i] *= Paso[i];
+      }
+      if ((k & 1023) == 1023) {
+         for (unsigned int i=0; i<K; i++) Fasor[i] /= std::abs(Fasor[i]);
+      }
+   }
+   // Con ciclos enteros en la ventana, la componente de la perturbación es exacta y la del
+   // controlador es la de U menos la de D:
+   for (unsigned int i=0; i<K; i++) {
+      F[i].D = Inicio[i] * (VENTANA / 2.0) / complejo(0, 1);
+      F[i].C = F[i].U - F[i].D;
+   }
+
+   // Energía de U (sin la media) que no explican los tonos inyectados:
+   double Total = SumaUU - SumaU * SumaU / VENTANA;
+   double Tonos = 0;
+   for (unsigned int i=0; i<K; i++) {
+      Tonos += 2 * std::norm(F[i].U) / VENTANA;
+   }
+   *DISTORSION = (Total > 0) ? std::max(0.0, 1 - Tonos / Total) : 1;
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static double FrecuenciaPunto(const analisis_frecuencia_s * A, unsigned int I)
+{
+   if (A->Puntos < 2) {
+      return A->Desde;
+   }
+   return A->Desde * pow(A->Hasta / A->Desde, double(I) / (A->Puntos - 1));
+}
+
+static void CompletarPunto(const fourier_s & F, double FRECUENCIA, double DISTORSION,
+                           bool SIMULADO, punto_frecuencia_s * P)
+// Las fases quedan entre -180 y 180; Desenvolver() las hace continuas.
+{
+   *P = punto_frecuencia_s();
+   P->Frecuencia = FRECUENCIA;
+   P->Distorsion = DISTORSION;
+   if (!SIMULADO || std::abs(F.U) == 0 || std::abs(F.Y) == 0 || std::abs(F.D) == 0) {
+      return;
+   }
+   complejo L = -F.C / F.U;
+   complejo C = -F.C / F.Y;
+   complejo G = F.Y / F.U;
+   complejo S = F.U / F.D;
+   P->LazoModulo        = std::abs(L);
+   P->LazoFase          = std::arg(L) * 180 / M_PI;
+   P->ControladorModulo = std::abs(C);
+   P->ControladorFase   = std::arg(C) * 180 / M_PI;
+   P->PlantaModulo      = std::abs(G);
+   P->PlantaFase        = std::arg(G) * 180 / M_PI;
+   P->Sensibilidad      = std::abs(S);
+   P->Complementaria    = std::abs(1.0 - S);
+   P->Valido            = DISTORSION <= FRECUENCIA_DISTORSION_MAXIMA;
+}
+
+static void MedirPunto(const pid_config_s * CONFIG, const analisis_frecuencia_s * A,
+                       unsigned int I, punto_frecuencia_s * P)
+// Seno escalonado: la ventana tiene Ciclos ciclos de la frecuencia del punto, que se ajusta
+// para que entren en un número entero de muestras.
+{
+   double T        = A->Planta.Periodo / 1e6;
+   double Pedida   = FrecuenciaPunto(A, I);
+   long   Ventana  = std::max(long(2 * A->Ciclos + 1), lround(A->Ciclos / (Pedida * T)));
+   tono_s Tono     = { long(A->Ciclos), Amplitud(CONFIG, A), 0 };
+   fourier_s F;
+   double Distorsion;
+   bool   Simulado = Inyectar(CONFIG, A, &Tono, 1, Ventana, &F, &Distorsion);
+   CompletarPunto(F, A->Ciclos / (Ventana * T), Distorsion, Simulado, P);
+}
+
+static void MedirMultiseno(const pid_config_s * CONFIG, const analisis_frecuencia_s * A,
+                           punto_frecuencia_s * PUNTOS)
+// Una ventana con Ciclos ciclos de la frecuencia más baja; cada frecuencia va al número entero
+// de ciclos más cercano (sin repetir). Fases de Schroeder, para que los picos de la suma no
+// saturen, y el valor eficaz de un seno de la amplitud pedida repartido entre los tonos.
+{
+   unsigned int K       = A->Puntos;
+   double       T       = A->Planta.Periodo / 1e6;
+   long         Ventana = std::max(long(4 * K + 2), lround(A->Ciclos / (A->Desde * T)));
+   std::vector<tono_s>    Tonos(K);
+   std::vector<fourier_s> F(K);
+   long Anterior = 0;
+   for (unsigned int i=0; i<K; i++) {
+      long Bin = std::max(Anterior + 1, lround(FrecuenciaPunto(A, i) * Ventana * T));
+      Tonos[i].Bin      = Bin;
+      Tonos[i].Amplitud = Amplitud(CONFIG, A) / sqrt(double(K));
+      Tonos[i].Fase     = -M_PI * i * (i + 1) / K;
+      Anterior = Bin;
+   }
+   double Distorsion;
+   bool   Simulado = (Anterior < Ventana / 2)
+                  && Inyectar(CONFIG, A, Tonos.data(), K, Ventana, F.data(), &Distorsion);
+   if (Anterior >= Ventana / 2) {
+      Distorsion = 1;                     // Más puntos que frecuencias bajo Nyquist
+   }
+   for (unsigned int i=0; i<K; i++) {
+      CompletarPunto(F[i], Tonos[i].Bin / (Ventana * T), Distorsion, Simulado, &PUNTOS[i]);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static void Desenvolver(punto_frecuencia_s * PUNTOS, unsigned int CANTIDAD)
+// Suma múltiplos de 360 para que la fase no salte más de 180 entre puntos válidos seguidos.
+{
+   double Lazo = 0, Controlador = 0, Planta = 0;
+   bool   Primero = true;
+   for (unsigned int i=0; i<CANTIDAD; i++) {
+      punto_frecuencia_s & P = PUNTOS[i];
+      if (!P.Valido) {
+         continue;
+      }
+      if (!Primero) {
+         P.LazoFase        -= 360 * round((P.LazoFase - Lazo) / 360);
+         P.ControladorFase -= 360 * round((P.ControladorFase - Controlador) / 360);
+         P.PlantaFase      -= 360 * round((P.PlantaFase - Planta) / 360);
+      }
+      Lazo        = P.LazoFase;
+      Controlador = P.ControladorFase;
+      Planta      = P.PlantaFase;
+      Primero     = false;
+   }
+}
+
+static void Medir(const pid_config_s * CONFIG, const analisis_frecuencia_s * A,
+                  punto_frecuencia_s * PUNTOS, unsigned int I)
+// Tarea I de una configuración: el punto I (seno escalonado) o todos (multiseno, I = 0).
+{
+   if (A->Multiseno) {
+      MedirMultiseno(CONFIG, A, PUNTOS);
+   } else {
+      MedirPunto(CONFIG, A, I, &PUNTOS[I]);
+   }
+}
+
+void MedirRespuesta(const pid_config_s * CONFIG, const analisis_frecuencia_s * ANALISIS,
+                    punto_frecuencia_s * PUNTOS)
+{
+   unsigned int Tareas = ANALISIS->Multiseno ? 1 : ANALISIS->Puntos;
+   for (unsigned int i=0; i<Tareas; i++) {
+      Medir(CONFIG, ANALISIS, PUNTOS, i);
+   }
+   Desenvolver(PUNTOS, ANALISIS->Puntos);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+margenes_s CalcularMargenes(const punto_frecuencia_s * PUNTOS, unsigned int CANTIDAD)
+// Entre dos puntos válidos seguidos se interpola linealmente en escala logarítmica de
+// frecuencia y de módulo. El margen de fase se toma en (-180, 180]; con varios cruces se
+// informa el peor.
+{
+   margenes_s M = {};
+   M.MargenGanancia = INFINITY;
+   M.MargenFase     = INFINITY;
+   const punto_frecuencia_s * A = 0;
+   for (unsigned int i=0; i<CANTIDAD; i++) {
+      const punto_frecuencia_s * B = &PUNTOS[i];
+      if (!B->Valido) {
+         continue;
+      }
+      M.Validos++;
+      if (B->Sensibilidad > M.PicoSensibilidad) {
+         M.PicoSensibilidad       = B->Sensibilidad;
+         M.FrecuenciaSensibilidad = B->Frecuencia;
+      }
+      if (B->Complementaria > M.PicoComplementaria) {
+         M.PicoComplementaria       = B->Complementaria;
+         M.FrecuenciaComplementaria = B->Frecuencia;
+      }
+      if (A != 0) {
+         double LogA = log(A->LazoModulo), LogB = log(B->LazoModulo);
+         double FA   = log(A->Frecuencia), FB   = log(B->Frecuencia);
+         // Cruce de ganancia (|L| = 1):
+         if ((LogA > 0) != (LogB > 0)) {
+            double t    = LogA / (LogA - LogB);
+            double Fase = A->LazoFase + t * (B->LazoFase - A->LazoFase);
+            double MF   = 180 + Fase;
+            MF -= 360 * ceil((MF - 180) / 360);
+            if (MF < M.MargenFase) {
+               M.MargenFase     = MF;
+               M.FrecuenciaFase = exp(FA + t * (FB - FA));
+            }
+         }
+         // Cruces de fase por -180 + 360 n:
+         double NA = floor((A->LazoFase + 180) / 360);
+         double NB = floor((B->LazoFase + 180) / 360);
+         if (NA != NB) {
+            double Cruce = 360 * std::max(NA, NB) - 180;
+            double t     = (Cruce - A->LazoFase) / (B->LazoFase - A->LazoFase);
+            double MG    = -20 * (LogA + t * (LogB - LogA)) / log(10.0);
+            if (MG < M.MargenGanancia) {
+               M.MargenGanancia     = MG;
+               M.FrecuenciaGanancia = exp(FA + t * (FB - FA));
+            }
+         }
+      }
+      A = B;
+   }
+   return M;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+double AnalizarConfiguraciones(const pid_config_s * CONFIGS, size_t CANTIDAD,
+                               const analisis_frecuencia_s * ANALISIS,
+                               punto_frecuencia_s * PUNTOS, margenes_s * MARGENES,
+                               unsigned int HILOS)
+// Cada tarea es un punto de una configuración (o el multiseno de una configuración); los
+// hilos las toman de a una, así las frecuencias bajas (simulaciones largas) no quedan todas
+// en el mismo hilo.
+{
+   unsigned int             N      = ANALISIS->Puntos;
+   unsigned int             PorCfg = ANALISIS->Multiseno ? 1 : N;
+   size_t                   Tareas = CANTIDAD * PorCfg;
+   std::atomic<size_t>      Siguiente(0);
+   std::vector<std::thread> Hilos;
+
+   if (HILOS==0) HILOS = std::thread::hardware_concurrency();
+   if (HILOS==0) HILOS = 1;
+
+   auto Trabajar = [&]() {
+      size_t t;
+      while ( (t = Siguiente.fetch_add(1)) < Tareas ) {
+         size_t c = t / PorCfg;
+         Medir(&CONFIGS[c], ANALISIS, &PUNTOS[c * N], unsigned(t % PorCfg));
+      }
+   };
+
+   double Comienzo = SegundosMonotonicos();
+   for (unsigned int h=1; h<HILOS; h++) Hilos.emplace_back(Trabajar);
+   Trabajar();
+   for (std::thread & H : Hilos) H.join();
+   for (size_t c=0; c<CANTIDAD; c++) {
+      Desenvolver(&PUNTOS[c * N], N);
+      MARGENES[c] = CalcularMargenes(&PUNTOS[c * N], N);
+   }
+   return SegundosMonotonicos() - Comienzo;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/frecuencia_pid.cpp
+**************************************************************************************************/
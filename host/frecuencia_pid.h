@@ -0,0 +1,90 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/frecuencia_pid.h
+* Breve:      Respuesta en frecuencia y márgenes de estabilidad de controlPID con una planta de
+*             control-pid-planta_sca, medidos sobre la implementación discreta real (integral
+*             trapezoidal, compensación de la integral, derivada del error, límites).
+*             El lazo se simula cerrado y asentado en el objetivo, y se suma una perturbación
+*             senoidal D a la entrada de la planta (U = salida del controlador C + D). Con las
+*             componentes de Fourier de U, C y la medición Y en una ventana de ciclos enteros:
+*                L = -C/U (lazo abierto), S = U/D = 1/(1+L), T = 1-S,
+*                controlador = -C/Y, planta = Y/U.
+*             Cada frecuencia se mide en su propia simulación (seno escalonado), o todas juntas
+*             con un multiseno de fases de Schroeder. Las simulaciones se reparten entre hilos.
+*             La Distorsion de cada punto es la fracción de la energía de U que no está en las
+*             frecuencias inyectadas: cerca de 0 en un lazo lineal; grande si la salida satura
+*             o el lazo es inestable, y entonces el punto no se usa para los márgenes.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef FRECUENCIA_PID_H
+#define FRECUENCIA_PID_H
+
+#include "simulador_pid.h"
+
+#define FRECUENCIA_DISTORSION_MAXIMA 0.05  // Distorsión con la que un punto deja de ser válido
+
+struct analisis_frecuencia_s {
+   simulacion_s  Planta;                  // Modelo, Ganancia, Tau, Retardo, Zeta, Inicial,
+                                          // Objetivo (punto de operación) y Periodo
+   double        Desde;                   // Frecuencias en Hz, espaciadas logarítmicamente
+   double        Hasta;
+   unsigned int  Puntos;
+   float         Amplitud;                // Amplitud de la perturbación (unidades de salida)
+   float         Asentamiento;            // Segundos de lazo cerrado antes de inyectar
+   unsigned int  Ciclos;                  // Ciclos por ventana de medición (en multiseno, de
+                                          // la frecuencia más baja)
+   bool          Multiseno;               // true: todas las frecuencias en una simulación
+};
+
+struct punto_frecuencia_s {
+   double Frecuencia;                     // Hz (ajustada a ciclos enteros en la ventana)
+   double LazoModulo;                     // |L|
+   double LazoFase;                       // Grados, continua entre puntos (sin saltos de 360)
+   double ControladorModulo;
+   double ControladorFase;
+   double PlantaModulo;
+   double PlantaFase;
+   double Sensibilidad;                   // |S|
+   double Complementaria;                 // |T|
+   double Distorsion;
+   bool   Valido;
+};
+
+struct margenes_s {
+   double MargenGanancia;                 // dB (infinito si la fase no cruza -180)
+   double FrecuenciaGanancia;             // Hz del cruce de fase
+   double MargenFase;                     // Grados (infinito si |L| no cruza 1)
+   double FrecuenciaFase;                 // Hz del cruce de ganancia
+   double PicoSensibilidad;               // Ms = max |S|
+   double FrecuenciaSensibilidad;
+   double PicoComplementaria;             // Mt = max |T|
+   double FrecuenciaComplementaria;
+   unsigned int Validos;                  // Puntos usados
+};
+
+analisis_frecuencia_s AnalisisPredeterminado();
+                                          // La planta de Ejemplo_simulacion, de 1/(1000 Tau) Hz
+                                          // a 0,45 de la frecuencia de muestreo
+
+void MedirRespuesta(const pid_config_s * CONFIG, const analisis_frecuencia_s * ANALISIS,
+                    punto_frecuencia_s * PUNTOS);
+                                          // ANALISIS->Puntos puntos de una configuración, sin
+                                          // hilos. Calcula además las fases continuas.
+
+margenes_s CalcularMargenes(const punto_frecuencia_s * PUNTOS, unsigned int CANTIDAD);
+                                          // Márgenes y picos con los puntos válidos.
+
+double AnalizarConfiguraciones(const pid_config_s * CONFIGS, size_t CANTIDAD,
+                               const analisis_frecuencia_s * ANALISIS,
+                               punto_frecuencia_s * PUNTOS, margenes_s * MARGENES,
+                               unsigned int HILOS);
+                                          // Respuesta (CANTIDAD * Puntos, por configuración) y
+                                          // márgenes de cada configuración, con las frecuencias
+                                          // (o los multisenos) repartidos en HILOS hilos (0:
+                                          // todos los núcleos). Devuelve los segundos.
+
+#endif // FRECUENCIA_PID_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
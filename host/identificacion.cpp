@@ -0,0 +1,396 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/identificacion.cpp
+* Breve:      Identificación por mínimos cuadrados. Ver host/identificacion.h.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "identificacion.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#define SALTO_PERIODO     0.5             // Variación del período que corta la historia
+#define MEJORA_SEGUNDO    10              // Diferencia de criterio para preferir segundo orden
+
+static bool Resolver(uint8_t N, const double * P, const double * Q, double * X)
+// Resuelve P X = Q, con P simétrica de NxN dada por su triángulo inferior (filas de 5
+// elementos). Eliminación gaussiana con pivoteo parcial; false si P es singular.
+{
+   double A[5][6];
+   double Escala = 0;
+   for (uint8_t i=0; i<N; i++) {
+      for (uint8_t j=0; j<N; j++) {
+         A[i][j] = (j <= i) ? P[i*5+j] : P[j*5+i];
+      }
+      A[i][N] = Q[i];
+      Escala  = fmax(Escala, A[i][i]);
+   }
+   for (uint8_t c=0; c<N; c++) {
+      uint8_t Pivote = c;
+      for (uint8_t i=c+1; i<N; i++) {
+         if (fabs(A[i][c]) > fabs(A[Pivote][c])) Pivote = i;
+      }
+      if (!(fabs(A[Pivote][c]) > 1e-12 * Escala)) {
+         return false;                    // Sin excitación: columnas dependientes
+      }
+      for (uint8_t j=0; j<=N; j++) {
+         double SW = A[c][j]; A[c][j] = A[Pivote][j]; A[Pivote][j] = SW;
+      }
+      for (uint8_t i=c+1; i<N; i++) {
+         double F = A[i][c] / A[c][c];
+         for (uint8_t j=c; j<=N; j++) A[i][j] -= F * A[c][j];
+      }
+   }
+   for (int i=N-1; i>=0; i--) {
+      double S = A[i][N];
+      for (uint8_t j=i+1; j<N; j++) S -= A[i][j] * X[j];
+      X[i] = S / A[i][i];
+   }
+   return true;
+}
+
+static double ErrorCuadratico(uint8_t N, const double * Q, const double * X, double SUMA_YY)
+// Con la solución de mínimos cuadrados, la suma de los residuos al cuadrado es Syy - X'Q.
+{
+   double E = SUMA_YY;
+   for (uint8_t i=0; i<N; i++) E -= X[i] * Q[i];
+   return fmax(E, 0);
+}
+
+/**************************************************************************************************
+* Funciones públicas
+**************************************************************************************************/
+
+acumuladorIdentificacion::acumuladorIdentificacion()
+{
+   memset(SumaU,   0, sizeof(SumaU));
+   memset(SumaUU,  0, sizeof(SumaUU));
+   memset(SumaUU1, 0, sizeof(SumaUU1));
+   memset(SumaY1U, 0, sizeof(SumaY1U));
+   memset(SumaY2U, 0, sizeof(SumaY2U));
+   memset(SumaYU,  0, sizeof(SumaYU));
+   SumaY1       = 0;
+   SumaY2       = 0;
+   SumaY1Y1     = 0;
+   SumaY1Y2     = 0;
+   SumaY2Y2     = 0;
+   SumaY1Y      = 0;
+   SumaY2Y      = 0;
+   SumaY        = 0;
+   SumaYY       = 0;
+   SumaPeriodos = 0;
+   Filas        = 0;
+   Muestras     = 0;
+   SumaMedicion = 0;
+   SalidaMinima = FLT_MAX;
+   SalidaMaxima = -FLT_MAX;
+   Cortar();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void acumuladorIdentificacion::Agregar(double TIEMPO, float SALIDA, float MEDICION)
+// Una fila se forma recién con R+1 muestras consecutivas, cuando ya están todas las entradas
+// anteriores que usa el mayor retardo: así todos los retardos tienen las mismas filas, sus
+// errores se comparan entre sí y sus sumas se comparten (unas 6 por desplazamiento en lugar
+// de 20 por retardo).
+{
+   if (!isfinite(SALIDA) || !isfinite(MEDICION)) {
+      Cortar();
+      return;
+   }
+   double Dt    = TIEMPO - TiempoAnterior;
+   bool   Salto = !(Dt > 0) ||
+                  (Previas > 1 && fabs(Dt - PeriodoAnterior) > SALTO_PERIODO * PeriodoAnterior);
+   if (Previas > 0 && Salto) {
+      Cortar();
+   }
+   Muestras++;
+   SumaMedicion = SumaMedicion + MEDICION;
+   SalidaMinima = fminf(SalidaMinima, SALIDA);
+   SalidaMaxima = fmaxf(SalidaMaxima, SALIDA);
+
+   if (Previas > R) {
+      double Y = MEDICION, A = Y1, B = Y2;
+      for (uint8_t j=0; j<=R; j++) {
+         double Uj = U[j];
+         SumaU[j]   += Uj;
+         SumaUU[j]  += Uj * Uj;
+         SumaY1U[j] += A * Uj;
+         SumaY2U[j] += B * Uj;
+         SumaYU[j]  += Y * Uj;
+      }
+      for (uint8_t j=0; j<R; j++) {
+         SumaUU1[j] += double(U[j]) * U[j+1];
+      }
+      SumaY1       += A;
+      SumaY2       += B;
+      SumaY1Y1     += A * A;
+      SumaY1Y2     += A * B;
+      SumaY2Y2     += B * B;
+      SumaY1Y      += A * Y;
+      SumaY2Y      += B * Y;
+      SumaY        += Y;
+      SumaYY       += Y * Y;
+      SumaPeriodos += Dt;
+      Filas++;
+   }
+
+   if (Previas > 0) {
+      PeriodoAnterior = Dt;
+   }
+   memmove(&U[1], &U[0], R * sizeof(U[0]));
+   U[0]           = SALIDA;
+   Y2             = Y1;
+   Y1             = MEDICION;
+   TiempoAnterior = TIEMPO;
+   Previas++;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void acumuladorIdentificacion::Cortar()
+{
+   Previas         = 0;
+   PeriodoAnterior = 0;
+   TiempoAnterior  = 0;
+   Y1              = 0;
+   Y2              = 0;
+   memset(U, 0, sizeof(U));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void acumuladorIdentificacion::Sumar(const acumuladorIdentificacion & OTRO)
+{
+   for (uint8_t j=0; j<=R; j++) {
+      SumaU[j]   += OTRO.SumaU[j];
+      SumaUU[j]  += OTRO.SumaUU[j];
+      SumaY1U[j] += OTRO.SumaY1U[j];
+      SumaY2U[j] += OTRO.SumaY2U[j];
+      SumaYU[j]  += OTRO.SumaYU[j];
+   }
+   for (uint8_t j=0; j<R; j++) {
+      SumaUU1[j] += OTRO.SumaUU1[j];
+   }
+   SumaY1       += OTRO.SumaY1;
+   SumaY2       += OTRO.SumaY2;
+   SumaY1Y1     += OTRO.SumaY1Y1;
+   SumaY1Y2     += OTRO.SumaY1Y2;
+   SumaY2Y2     += OTRO.SumaY2Y2;
+   SumaY1Y      += OTRO.SumaY1Y;
+   SumaY2Y      += OTRO.SumaY2Y;
+   SumaY        += OTRO.SumaY;
+   SumaYY       += OTRO.SumaYY;
+   SumaPeriodos += OTRO.SumaPeriodos;
+   Filas        += OTRO.Filas;
+   Muestras     += OTRO.Muestras;
+   SumaMedicion += OTRO.SumaMedicion;
+   SalidaMinima  = fminf(SalidaMinima, OTRO.SalidaMinima);
+   SalidaMaxima  = fmaxf(SalidaMaxima, OTRO.SalidaMaxima);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+unsigned long acumuladorIdentificacion::CantidadMuestras() const
+{
+   return Muestras;
+}
+
+unsigned long acumuladorIdentificacion::CantidadFilas() const
+{
+   return Filas;
+}
+
+double acumuladorIdentificacion::Periodo() const
+{
+   return (Filas > 0) ? SumaPeriodos / Filas : 0;
+}
+
+float acumuladorIdentificacion::MinimoSalida() const
+{
+   return (Muestras > 0) ? SalidaMinima : 0;
+}
+
+float acumuladorIdentificacion::MaximoSalida() const
+{
+   return (Muestras > 0) ? SalidaMaxima : 0;
+}
+
+float acumuladorIdentificacion::MedicionMedia() const
+{
+   return (Muestras > 0) ? SumaMedicion / Muestras : 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool acumuladorIdentificacion::AjustarPrimerOrden(modelo_primer_orden_s * MODELO) const
+// a = e^(-h/Tau) y b = K (1-a) son la discretización exacta con retención de orden cero.
+{
+   double Mejor = -1, Theta[3] = {}, X[3];
+   uint8_t Retardo = 0;
+   *MODELO = {};
+   for (uint8_t d=0; d<R && Filas > 3; d++) {
+      double P[5*5], Q[5];
+      Ecuaciones(d, false, P, Q);
+      if (!Resolver(3, P, Q, X)) continue;
+      double E = ErrorCuadratico(3, Q, X, SumaYY);
+      if (Mejor < 0 || E < Mejor) {
+         Mejor   = E;
+         Retardo = d;
+         memcpy(Theta, X, sizeof(X));
+      }
+   }
+   double h = Periodo() / 1e6;
+   double a = Theta[0], b = Theta[1], c = Theta[2];
+   if (Mejor < 0 || !(a > 0 && a < 1) || h <= 0) {
+      return false;                       // Integrador, oscilante o sin datos
+   }
+   double Total = SumaYY - SumaY * SumaY / Filas;
+   MODELO->Valido          = true;
+   MODELO->Ganancia        = b / (1 - a);
+   MODELO->Tau             = -h / log(a);
+   MODELO->RetardoMuestras = Retardo;
+   MODELO->Retardo         = Retardo * h;
+   MODELO->Desplazamiento  = c / (1 - a);
+   MODELO->R2              = (Total > 0) ? 1 - Mejor / Total : 1;
+   MODELO->RMS             = sqrt(Mejor / Filas);
+   MODELO->Criterio        = Filas * log(fmax(Mejor / Filas, DBL_MIN)) + 2 * 4;
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool acumuladorIdentificacion::AjustarSegundoOrden(modelo_segundo_orden_s * MODELO) const
+// Los polos discretos z son las raíces de z^2 - a1 z - a2; cada uno corresponde a un polo
+// continuo s = ln(z) / h, de donde salen Wn = |s| y Zeta = -Re(s) / |s|.
+{
+   double Mejor = -1, Theta[5] = {}, X[5];
+   uint8_t Retardo = 0;
+   *MODELO = {};
+   for (uint8_t d=0; d<R && Filas > 5; d++) {
+      double P[5*5], Q[5];
+      Ecuaciones(d, true, P, Q);
+      if (!Resolver(5, P, Q, X)) continue;
+      double E = ErrorCuadratico(5, Q, X, SumaYY);
+      if (Mejor < 0 || E < Mejor) {
+         Mejor   = E;
+         Retardo = d;
+         memcpy(Theta, X, sizeof(X));
+      }
+   }
+   double h  = Periodo() / 1e6;
+   double a1 = Theta[0], a2 = Theta[1];
+   if (Mejor < 0 || h <= 0 || 1 - a1 - a2 == 0) {
+      return false;
+   }
+   double Discriminante = a1*a1 + 4*a2;
+   double Wn, Zeta;
+   if (Discriminante >= 0) {              // Polos reales: ambos deben estar en (0, 1)
+      double Z1 = (a1 + sqrt(Discriminante)) / 2;
+      double Z2 = (a1 - sqrt(Discriminante)) / 2;
+      if (!(Z1 < 1 && Z2 > 0)) {
+         return false;
+      }
+      double S1 = log(Z1) / h, S2 = log(Z2) / h;
+      Wn   = sqrt(S1 * S2);
+      Zeta = -(S1 + S2) / (2 * Wn);
+   } else {                               // Polos complejos: módulo sqrt(-a2) menor que 1
+      double Modulo = sqrt(-a2);
+      if (!(Modulo < 1)) {
+         return false;
+      }
+      double Real   = log(Modulo) / h;
+      double Imag   = atan2(sqrt(-Discriminante) / 2, a1 / 2) / h;
+      Wn   = sqrt(Real*Real + Imag*Imag);
+      Zeta = -Real / Wn;
+   }
+   double Total = SumaYY - SumaY * SumaY / Filas;
+   MODELO->Valido          = true;
+   MODELO->Ganancia        = (Theta[2] + Theta[3]) / (1 - a1 - a2);
+   MODELO->Wn              = Wn;
+   MODELO->Zeta            = Zeta;
+   MODELO->RetardoMuestras = Retardo;
+   MODELO->Retardo         = Retardo * h;
+   MODELO->Desplazamiento  = Theta[4] / (1 - a1 - a2);
+   MODELO->R2              = (Total > 0) ? 1 - Mejor / Total : 1;
+   MODELO->RMS             = sqrt(Mejor / Filas);
+   MODELO->Criterio        = Filas * log(fmax(Mejor / Filas, DBL_MIN)) + 2 * 6;
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool SugerirPID(const modelo_primer_orden_s * PRIMER, const modelo_segundo_orden_s * SEGUNDO,
+                float TAU_C, pid_config_s * CONFIG)
+// SIMC: Kc = Tau1 / (K (Tauc + Retardo)), Ti = min(Tau1, 4 (Tauc + Retardo)), Td = Tau2 (forma
+// serie). controlPID usa la forma paralela, así que el PID se convierte:
+// Kp = Kc (1 + Td/Ti), Ti' = Ti + Td, Td' = Ti Td / (Ti + Td).
+{
+   double K, Tau1, Tau2 = 0, Retardo;
+   bool   Segundo = SEGUNDO && SEGUNDO->Valido && SEGUNDO->Zeta >= 1 &&
+                    (!PRIMER || !PRIMER->Valido ||
+                     SEGUNDO->Criterio < PRIMER->Criterio - MEJORA_SEGUNDO);
+   if (Segundo) {
+      double Raiz = sqrt(SEGUNDO->Zeta * SEGUNDO->Zeta - 1);
+      K       = SEGUNDO->Ganancia;
+      Tau1    = (SEGUNDO->Zeta + Raiz) / SEGUNDO->Wn;
+      Tau2    = (SEGUNDO->Zeta - Raiz) / SEGUNDO->Wn;
+      Retardo = SEGUNDO->Retardo;
+   } else if (PRIMER && PRIMER->Valido) {
+      K       = PRIMER->Ganancia;
+      Tau1    = PRIMER->Tau;
+      Retardo = PRIMER->Retardo;
+   } else {
+      return false;
+   }
+   if (K == 0) {
+      return false;
+   }
+   double Tauc = (TAU_C > 0) ? TAU_C : fmax(Retardo, Tau1 / 5);
+   double Kc   = Tau1 / (K * (Tauc + Retardo));
+   double Ti   = fmin(Tau1, 4 * (Tauc + Retardo));
+   CONFIG->Kp = Kc * (1 + Tau2 / Ti);
+   CONFIG->Ti = Ti + Tau2;
+   CONFIG->Td = Ti * Tau2 / (Ti + Tau2);
+   return true;
+}
+
+/**************************************************************************************************
+* Funciones privadas
+**************************************************************************************************/
+
+void acumuladorIdentificacion::Ecuaciones(uint8_t RETARDO, bool SEGUNDO, double * P,
+                                          double * Q) const
+// Regresores x = [y[k], u[k-d], 1] o [y[k], y[k-1], u[k-d], u[k-d-1], 1].
+{
+   uint8_t d = RETARDO;
+   double  N = Filas;
+   if (!SEGUNDO) {
+      P[0*5+0] = SumaY1Y1;
+      P[1*5+0] = SumaY1U[d];  P[1*5+1] = SumaUU[d];
+      P[2*5+0] = SumaY1;      P[2*5+1] = SumaU[d];   P[2*5+2] = N;
+      Q[0] = SumaY1Y;
+      Q[1] = SumaYU[d];
+      Q[2] = SumaY;
+      return;
+   }
+   P[0*5+0] = SumaY1Y1;
+   P[1*5+0] = SumaY1Y2;     P[1*5+1] = SumaY2Y2;
+   P[2*5+0] = SumaY1U[d];   P[2*5+1] = SumaY2U[d];   P[2*5+2] = SumaUU[d];
+   P[3*5+0] = SumaY1U[d+1]; P[3*5+1] = SumaY2U[d+1]; P[3*5+2] = SumaUU1[d]; P[3*5+3] = SumaUU[d+1];
+   P[4*5+0] = SumaY1;       P[4*5+1] = SumaY2;       P[4*5+2] = SumaU[d];   P[4*5+3] = SumaU[d+1];
+   P[4*5+4] = N;
+   Q[0] = SumaY1Y;
+   Q[1] = SumaY2Y;
+   Q[2] = SumaYU[d];
+   Q[3] = SumaYU[d+1];
+   Q[4] = SumaY;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/identificacion.cpp
+**************************************************************************************************/
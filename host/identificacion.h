@@ -0,0 +1,120 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/identificacion.h
+* Breve:      Identificación de la planta por mínimos cuadrados a partir de muestras (tiempo,
+*             salida del controlador, medición) tomadas con el lazo funcionando.
+*             Se ajustan dos modelos discretos con la salida retenida durante el período:
+*             - Primer orden:  y[k+1] = a y[k] + b u[k-d] + c
+*             - Segundo orden: y[k+1] = a1 y[k] + a2 y[k-1] + b1 u[k-d] + b2 u[k-d-1] + c
+*             para cada retardo d de 0 a PLANTA_RETARDO_MAXIMO-1 muestras. El acumulador guarda
+*             sólo las ecuaciones normales (sumas de productos), así que los datos se recorren
+*             una vez, sin guardarlos, y los acumuladores de distintos bloques o archivos se
+*             suman. Al final se elige el retardo de menor error y se pasa cada modelo a los
+*             parámetros continuos de control-pid-planta_sca (K, Tau, Wn, Zeta, Retardo).
+*             Un salto en el tiempo (período que difiere más del 50% del anterior, o que no
+*             avanza) corta la historia: no se forman ecuaciones entre muestras no consecutivas.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef IDENTIFICACION_H
+#define IDENTIFICACION_H
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+#include "control-pid-planta_sca.h"
+
+#define IDENTIFICACION_RETARDOS PLANTA_RETARDO_MAXIMO   // Retardos probados (0 a RETARDOS-1)
+
+struct modelo_primer_orden_s {            // K e^(-Retardo s) / (Tau s + 1) + Desplazamiento
+   bool    Valido;                        // false: datos sin excitación o modelo inestable
+   float   Ganancia;
+   float   Tau;                           // En segundos
+   float   Retardo;                       // En segundos (RetardoMuestras períodos)
+   uint8_t RetardoMuestras;
+   float   Desplazamiento;                // Medición con salida 0
+   double  R2;                            // Coeficiente de determinación de la predicción
+   double  RMS;                           // Error medio de la predicción a un paso
+   double  Criterio;                      // Criterio de Akaike (menor: mejor)
+};
+
+struct modelo_segundo_orden_s {           // K Wn^2 e^(-Retardo s) / (s^2 + 2 Zeta Wn s + Wn^2)
+   bool    Valido;
+   float   Ganancia;
+   float   Wn;                            // En rad/s
+   float   Zeta;
+   float   Retardo;
+   uint8_t RetardoMuestras;
+   float   Desplazamiento;
+   double  R2;
+   double  RMS;
+   double  Criterio;
+};
+
+class acumuladorIdentificacion            // Ecuaciones normales de los dos modelos
+{
+   private:
+   static const uint8_t R = IDENTIFICACION_RETARDOS;
+   // Todos los retardos usan las mismas filas, así que sus ecuaciones normales se arman con
+   // sumas por desplazamiento j de la entrada (U[j] = u[k-j]) más las sumas de la medición:
+   double        SumaU[R+1];              // Suma de u[k-j]
+   double        SumaUU[R+1];             // Suma de u[k-j]^2
+   double        SumaUU1[R];              // Suma de u[k-j] u[k-j-1]
+   double        SumaY1U[R+1];            // Suma de y[k] u[k-j]
+   double        SumaY2U[R+1];            // Suma de y[k-1] u[k-j]
+   double        SumaYU[R+1];             // Suma de y[k+1] u[k-j]
+   double        SumaY1, SumaY2;          // Sumas de y[k] e y[k-1]...
+   double        SumaY1Y1, SumaY1Y2, SumaY2Y2;
+   double        SumaY1Y, SumaY2Y;        // ... y de sus productos con y[k+1]
+   double        SumaY;                   // Sumas de las mediciones predichas y[k+1]
+   double        SumaYY;
+   double        SumaPeriodos;            // En microsegundos
+   unsigned long Filas;                   // Ecuaciones acumuladas
+   unsigned long Muestras;                // Muestras recibidas
+   double        SumaMedicion;
+   float         SalidaMinima;
+   float         SalidaMaxima;
+
+   // Historia de la serie en curso (no se suma entre acumuladores):
+   float         U[R+1];                  // U[j] = u[k-j], la más reciente primero
+   float         Y1;                      // y[k]
+   float         Y2;                      // y[k-1]
+   double        TiempoAnterior;
+   double        PeriodoAnterior;
+   unsigned long Previas;                 // Muestras consecutivas en la historia
+
+   void Ecuaciones(uint8_t RETARDO, bool SEGUNDO, double * P, double * Q) const;
+                                          // P (triángulo inferior, filas de 5) y Q del modelo.
+
+   public:
+   acumuladorIdentificacion();
+   void Agregar(double TIEMPO, float SALIDA, float MEDICION);
+                                          // Una muestra: TIEMPO en microsegundos, SALIDA del
+                                          // controlador (entrada de la planta) y MEDICION.
+   void Cortar();                         // La próxima muestra no sigue a la anterior.
+   void Sumar(const acumuladorIdentificacion & OTRO);
+                                          // Agrega las ecuaciones de OTRO (otro bloque).
+   unsigned long CantidadMuestras() const;
+   unsigned long CantidadFilas() const;
+   double Periodo() const;                // Período medio, en microsegundos
+   float  MinimoSalida() const;
+   float  MaximoSalida() const;
+   float  MedicionMedia() const;
+   bool AjustarPrimerOrden(modelo_primer_orden_s * MODELO) const;
+   bool AjustarSegundoOrden(modelo_segundo_orden_s * MODELO) const;
+                                          // Ajustan el modelo con el mejor retardo. Devuelven
+                                          // MODELO->Valido.
+};
+
+bool SugerirPID(const modelo_primer_orden_s * PRIMER, const modelo_segundo_orden_s * SEGUNDO,
+                float TAU_C, pid_config_s * CONFIG);
+                                          // Sintonía SIMC (Skogestad): PI con el modelo de
+                                          // primer orden, o PID si el de segundo orden es
+                                          // sobreamortiguado y ajusta claramente mejor. TAU_C es
+                                          // la constante de tiempo buscada en lazo cerrado
+                                          // (0: max(Retardo, Tau/5)). Sólo cambia Kp, Ti y Td;
+                                          // devuelve false si no hay un modelo válido.
+
+#endif // IDENTIFICACION_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
@@ -0,0 +1,344 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/identificar_planta.cpp
+* Breve:      Identifica la planta a partir de registros de lazos en funcionamiento y sugiere una
+*             sintonía, sin detener el proceso para ensayarlo.
+*             Cada archivo puede ser CSV (una muestra por línea: tiempo, salida del controlador y
+*             medición; las líneas que no son números se saltean) o una traza binaria de
+*             grabadorPID (se usan sus muestras); el formato se detecta solo. Los archivos se
+*             mapean en memoria y se parten en bloques (en límites de línea, o resincronizando
+*             las tramas) que los hilos acumulan por separado con host/identificacion; las
+*             ecuaciones de los bloques se suman en orden, así que el resultado no depende de la
+*             cantidad de hilos. La memoria usada no depende del tamaño de los registros.
+*             Imprime los modelos de primer orden con retardo y de segundo orden como
+*             constructores de control-pid-planta_sca y opciones de barrido_pid, y un
+*             pid_config_s sugerido con los límites de la salida registrada.
+* Uso:        identificar_planta ARCHIVO... [--hilos N] [--bloque MB] [--tiempo us|ms|s]
+*                                [--columnas T,U,Y] [--tau-c S]
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+#include "control-pid-grabador_sca.h"
+#include "identificacion.h"
+#include "medicion.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define BLOQUE_PREDETERMINADO 8           // Megabytes por bloque
+#define COLUMNAS_MAXIMAS      64          // Columnas CSV que se leen por línea
+#define LINEA_MAXIMA          512         // Caracteres de cada línea que se analizan
+
+struct archivo_s {
+   const char *    Nombre;
+   const uint8_t * Datos;
+   size_t          Tamanio;
+   bool            Binario;               // Traza de grabadorPID
+};
+
+struct bloque_s {
+   size_t          Archivo;
+   size_t          Inicio;                // CSV: comienzo de línea. Traza: primer byte en que
+   size_t          Fin;                   // puede empezar una trama del bloque.
+};
+
+struct opciones_s {
+   double          EscalaTiempo;          // Microsegundos por unidad de tiempo del CSV
+   int             Columna[3];            // Tiempo, salida y medición
+   int             Ultima;                // Mayor de las tres columnas
+};
+
+static void Uso()
+{
+   fprintf(stderr, "Uso: identificar_planta ARCHIVO... [--hilos N] [--bloque MB] "
+                   "[--tiempo us|ms|s]\n"
+                   "                          [--columnas T,U,Y] [--tau-c S]\n");
+   exit(1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static bool EsTraza(const uint8_t * DATOS, size_t TAMANIO)
+// Una captura del puerto serie puede empezar a mitad de una trama: se busca una trama válida
+// entre los primeros bytes. En un CSV no aparece 0xA5 (y si aparece, falla el CRC).
+{
+   pid_evento_s Evento;
+   size_t Limite = (TAMANIO < 256) ? TAMANIO : 256;
+   for (size_t i=0; i<Limite; i++) {
+      if (DATOS[i] == TRAZA_SINCRONISMO_1 && LeerTramaTraza(&DATOS[i], TAMANIO-i, &Evento) > 0) {
+         return true;
+      }
+   }
+   return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static unsigned long AcumularCSV(const archivo_s & A, const bloque_s & B, const opciones_s & OP,
+                                 acumuladorIdentificacion * ACUMULADOR)
+// Devuelve las líneas descartadas (encabezados, vacías o con menos columnas).
+{
+   unsigned long Descartadas = 0;
+   const char *  Texto = (const char *) A.Datos;
+   size_t        Posicion = B.Inicio;
+   double        Valores[COLUMNAS_MAXIMAS];
+   char          Copia[LINEA_MAXIMA];
+
+   while (Posicion < B.Fin) {
+      const char * Linea   = &Texto[Posicion];
+      const char * FinLinea = (const char *) memchr(Linea, '\n', A.Tamanio - Posicion);
+      if (!FinLinea) FinLinea = &Texto[A.Tamanio];
+      Posicion = FinLinea - Texto + 1;
+
+      // Copia terminada en 0 (strtod no debe pasar del fin del mapeo en la última línea) y
+      // campos numéricos separados por coma, punto y coma, tabulador o espacios:
+      size_t Largo = FinLinea - Linea;
+      if (Largo > 0 && Linea[Largo-1] == '\r') Largo--;
+      if (Largo >= LINEA_MAXIMA) Largo = LINEA_MAXIMA - 1;
+      memcpy(Copia, Linea, Largo);
+      Copia[Largo] = 0;
+      char * P = Copia;
+      int Leidas = 0;
+      while (Leidas <= OP.Ultima && *P) {
+         char * Siguiente;
+         Valores[Leidas] = strtod(P, &Siguiente);
+         if (Siguiente == P) break;
+         Leidas++;
+         P = Siguiente;
+         while (*P == ' ' || *P == '\t') P++;
+         if (*P == ',' || *P == ';') P++;
+      }
+      if (Leidas <= OP.Ultima) {
+         if (Largo > 0) Descartadas++;
+         ACUMULADOR->Cortar();
+         continue;
+      }
+      ACUMULADOR->Agregar(Valores[OP.Columna[0]] * OP.EscalaTiempo, Valores[OP.Columna[1]],
+                          Valores[OP.Columna[2]]);
+   }
+   return Descartadas;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static unsigned long AcumularTraza(const archivo_s & A, const bloque_s & B,
+                                   acumuladorIdentificacion * ACUMULADOR)
+// El bloque toma las tramas que empiezan antes de su fin, aunque terminen en el siguiente. El
+// tiempo grabado es micros() de 32 bits: se extiende sumando diferencias.
+// Devuelve los bytes descartados, sin contar los del comienzo del bloque (el resto de la trama
+// que empezó en el bloque anterior).
+{
+   unsigned long Descartados = 0;
+   pid_evento_s  Evento;
+   size_t        Posicion = B.Inicio;
+   bool          Primera  = true;
+   bool          Sincronizado = (B.Inicio == 0);
+   uint32_t      TiempoAnterior = 0;
+   double        Tiempo = 0;
+
+   while (Posicion < B.Fin) {
+      uint8_t Largo = LeerTramaTraza(&A.Datos[Posicion], A.Tamanio - Posicion, &Evento);
+      if (Largo == 0) {
+         Posicion++;
+         Descartados += Sincronizado;
+         continue;
+      }
+      Posicion    += Largo;
+      Sincronizado = true;
+      if (Evento.Tipo == TRAZA_APAGADO) {
+         ACUMULADOR->Cortar();
+      } else if (Evento.Tipo == TRAZA_MUESTRA) {
+         uint32_t Actual = uint32_t(Evento.Muestra.Tiempo);
+         Tiempo = Primera ? 0 : Tiempo + uint32_t(Actual - TiempoAnterior);
+         TiempoAnterior = Actual;
+         Primera = false;
+         ACUMULADOR->Agregar(Tiempo, Evento.Muestra.Salida, Evento.Muestra.Medicion);
+      }
+   }
+   return Descartados;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static void PartirArchivo(size_t ARCHIVO, const archivo_s & A, size_t BLOQUE,
+                          std::vector<bloque_s> * BLOQUES)
+{
+   size_t Inicio = 0;
+   while (Inicio < A.Tamanio) {
+      size_t Fin = (A.Tamanio - Inicio > BLOQUE) ? Inicio + BLOQUE : A.Tamanio;
+      if (!A.Binario && Fin < A.Tamanio) {
+         const void * Salto = memchr(&A.Datos[Fin], '\n', A.Tamanio - Fin);
+         Fin = Salto ? (const uint8_t *) Salto - A.Datos + 1 : A.Tamanio;
+      }
+      BLOQUES->push_back({ARCHIVO, Inicio, Fin});
+      Inicio = Fin;
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int main(int argc, char ** argv)
+{
+   std::vector<archivo_s> Archivos;
+   opciones_s   Opciones = { 1, {0, 1, 2}, 2 };
+   unsigned int Hilos  = 0;
+   double       Bloque = BLOQUE_PREDETERMINADO;
+   float        TauC   = 0;
+
+   for (int i=1; i<argc; i++) {
+      const char * Opcion = argv[i];
+      if (Opcion[0] != '-') {
+         Archivos.push_back({Opcion, NULL, 0, false});
+         continue;
+      }
+      if (i+1 >= argc) Uso();
+      const char * Valor = argv[++i];
+      if      (!strcmp(Opcion, "--hilos"))  Hilos = atoi(Valor);
+      else if (!strcmp(Opcion, "--bloque")) Bloque = atof(Valor);
+      else if (!strcmp(Opcion, "--tau-c"))  TauC = atof(Valor);
+      else if (!strcmp(Opcion, "--tiempo")) {
+         if      (!strcmp(Valor, "us")) Opciones.EscalaTiempo = 1;
+         else if (!strcmp(Valor, "ms")) Opciones.EscalaTiempo = 1e3;
+         else if (!strcmp(Valor, "s"))  Opciones.EscalaTiempo = 1e6;
+         else Uso();
+      }
+      else if (!strcmp(Opcion, "--columnas")) {
+         int * C = Opciones.Columna;
+         if (sscanf(Valor, "%d,%d,%d", &C[0], &C[1], &C[2]) != 3) Uso();
+         Opciones.Ultima = 0;
+         for (int c=0; c<3; c++) {
+            if (C[c] < 0 || C[c] >= COLUMNAS_MAXIMAS) Uso();
+            Opciones.Ultima = (C[c] > Opciones.Ultima) ? C[c] : Opciones.Ultima;
+         }
+      }
+      else Uso();
+   }
+   if (Archivos.empty() || !(Bloque > 0)) Uso();
+   if (Hilos == 0) Hilos = std::thread::hardware_concurrency();
+   if (Hilos == 0) Hilos = 1;
+
+   // Mapeo de los archivos y partición en bloques
+   std::vector<bloque_s> Bloques;
+   size_t Bytes = 0;
+   for (size_t a=0; a<Archivos.size(); a++) {
+      archivo_s & A = Archivos[a];
+      int Descriptor = open(A.Nombre, O_RDONLY);
+      struct stat Estado;
+      if (Descriptor < 0 || fstat(Descriptor, &Estado) < 0) {
+         fprintf(stderr, "No se pudo abrir %s\n", A.Nombre);
+         return 1;
+      }
+      A.Tamanio = Estado.st_size;
+      if (A.Tamanio > 0) {
+         void * Mapa = mmap(NULL, A.Tamanio, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+         if (Mapa == MAP_FAILED) {
+            fprintf(stderr, "No se pudo mapear %s\n", A.Nombre);
+            return 1;
+         }
+         madvise(Mapa, A.Tamanio, MADV_SEQUENTIAL);
+         A.Datos   = (const uint8_t *) Mapa;
+         A.Binario = EsTraza(A.Datos, A.Tamanio);
+      }
+      close(Descriptor);
+      Bytes += A.Tamanio;
+      PartirArchivo(a, A, size_t(Bloque * 1048576), &Bloques);
+   }
+
+   // Acumulación en paralelo: un acumulador por bloque
+   std::vector<acumuladorIdentificacion> Parciales(Bloques.size());
+   std::atomic<size_t>        Siguiente(0);
+   std::atomic<unsigned long> Descartados(0);
+   std::vector<std::thread>   Trabajadores;
+   double Inicio = SegundosMonotonicos();
+   if (Hilos > Bloques.size()) Hilos = Bloques.size() > 0 ? Bloques.size() : 1;
+   for (unsigned int h=0; h<Hilos; h++) {
+      Trabajadores.emplace_back([&]() {
+         size_t b;
+         while ((b = Siguiente.fetch_add(1)) < Bloques.size()) {
+            const bloque_s  & B = Bloques[b];
+            const archivo_s & A = Archivos[B.Archivo];
+            Descartados += A.Binario ? AcumularTraza(A, B, &Parciales[b])
+                                     : AcumularCSV(A, B, Opciones, &Parciales[b]);
+         }
+      });
+   }
+   for (std::thread & T : Trabajadores) T.join();
+   acumuladorIdentificacion Total;
+   for (const acumuladorIdentificacion & P : Parciales) Total.Sumar(P);
+
+   modelo_primer_orden_s  Primer;
+   modelo_segundo_orden_s Segundo;
+   Total.AjustarPrimerOrden(&Primer);
+   Total.AjustarSegundoOrden(&Segundo);
+   double Segundos = SegundosMonotonicos() - Inicio;
+
+   fprintf(stderr, "%zu archivos, %zu bloques, %u hilos, %.1f MB en %.3f s (%.0f MB/s), "
+                   "%lu descartados\n", Archivos.size(), Bloques.size(), Hilos, Bytes / 1048576.0,
+                   Segundos, Segundos > 0 ? Bytes / 1048576.0 / Segundos : 0,
+                   Descartados.load());
+
+   double Periodo = Total.Periodo();
+   float  Inicial = Total.MedicionMedia();
+   printf("Muestras: %lu (%lu ecuaciones), periodo medio %.0f us, salida %g a %g, "
+          "medicion media %g\n", Total.CantidadMuestras(), Total.CantidadFilas(), Periodo,
+          Total.MinimoSalida(), Total.MaximoSalida(), Inicial);
+   if (Primer.Valido) {
+      printf("\nPrimer orden con retardo: K=%g Tau=%g s Retardo=%g s (%u muestras) "
+             "Desplazamiento=%g R2=%.6f RMS=%g\n", Primer.Ganancia, Primer.Tau, Primer.Retardo,
+             Primer.RetardoMuestras, Primer.Desplazamiento, Primer.R2, Primer.RMS);
+      printf("   plantaPrimerOrdenRetardo Planta(%g, %g, %g, %g);\n", Primer.Ganancia,
+             Primer.Tau, Primer.Retardo, Inicial);
+      printf("   barrido_pid --ganancia %g --tau %g --retardo %g --periodo %.0f\n",
+             Primer.Ganancia, Primer.Tau, Primer.Retardo, Periodo);
+   } else {
+      printf("\nPrimer orden con retardo: sin ajuste (falta excitacion o no es de ese orden)\n");
+   }
+   if (Segundo.Valido) {
+      printf("\nSegundo orden: K=%g Wn=%g rad/s Zeta=%g Retardo=%g s (%u muestras) "
+             "Desplazamiento=%g R2=%.6f RMS=%g\n", Segundo.Ganancia, Segundo.Wn, Segundo.Zeta,
+             Segundo.Retardo, Segundo.RetardoMuestras, Segundo.Desplazamiento, Segundo.R2,
+             Segundo.RMS);
+      printf("   plantaSegundoOrden Planta(%g, %g, %g, %g);%s\n", Segundo.Ganancia, Segundo.Wn,
+             Segundo.Zeta, Inicial, Segundo.RetardoMuestras > 0 ? "   // sin el retardo" : "");
+      printf("   barrido_pid --ganancia %g --tau %g --zeta %g --periodo %.0f\n",
+             Segundo.Ganancia, 1 / Segundo.Wn, Segundo.Zeta, Periodo);
+   } else {
+      printf("\nSegundo orden: sin ajuste (falta excitacion o no es de ese orden)\n");
+   }
+
+   pid_config_s Config = {};
+   Config.Objetivo          = Inicial;
+   Config.LimiteSuperior    = Total.MaximoSalida();
+   Config.LimiteInferior    = Total.MinimoSalida();
+   Config.CompensarIntegral = true;
+   if (SugerirPID(&Primer, &Segundo, TauC, &Config)) {
+      printf("\nSintonia sugerida (SIMC, %s):\n", Config.Td > 0 ? "PID del modelo de segundo "
+             "orden" : "PI del modelo de primer orden");
+      printf("   pid_config_s Config = { %g, %g, %g, %g, %g, %g, true };\n", Config.Objetivo,
+             Config.Kp, Config.Ti, Config.Td, Config.LimiteSuperior, Config.LimiteInferior);
+   } else {
+      printf("\nSin sintonia sugerida: ningun modelo valido\n");
+   }
+
+   for (const archivo_s & A : Archivos) {
+      if (A.Datos) munmap((void *) A.Datos, A.Tamanio);
+   }
+   return (Primer.Valido || Segundo.Valido) ? 0 : 2;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/identificar_planta.cpp
+**************************************************************************************************/
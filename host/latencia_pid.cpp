@@ -0,0 +1,246 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/latencia_pid.cpp
+* Breve:      Compara la regularidad del muestreo de un controlPID con carga de fondo en loop():
+*             1) Sondeo: loop() llama a planificadorPID::Ejecutar() entre tareas de fondo de
+*                duración aleatoria (hasta --carga microsegundos), como en Ejemplo_simulacion.
+*             2) Timer: un timer POSIX (CLOCK_MONOTONIC) envía una señal al hilo principal y el
+*                manejador llama a interrupcionPID::Tic(), que interrumpe la tarea de fondo como
+*                lo haría una interrupción de hardware. loop() lee el estado con Leer() y cambia
+*                el objetivo con Reconfigurar(), sin bloquear el tic.
+*             En los dos casos se registra el instante real de cada lectura de la medición y se
+*             informa el período medio, el jitter (|intervalo - período|), el retraso respecto
+*             de la grilla ideal y los períodos perdidos. --hilos-carga agrega hilos que ocupan
+*             la CPU, para ver además el efecto del planificador del sistema.
+* Uso:        latencia_pid [--periodo US] [--segundos S] [--carga US] [--hilos-carga N]
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+#include "control-pid-planificador_sca.h"
+#include "control-pid-interrupcion_sca.h"
+#include "control-pid-planta_sca.h"
+
+#include <algorithm>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+static unsigned long              Periodo = 2000;
+static controlPID *               PID;
+static plantaPrimerOrden          Planta(1, 0.2f, 0);
+static std::vector<unsigned long> Instantes;        // Instante real de cada lectura
+static volatile size_t            Lecturas;
+static volatile bool              Terminar;
+static interrupcionPID *          Lazo;
+static pid_config_s               Configuracion;    // La del lazo, propia del contexto principal
+
+static unsigned long RelojReal()          // Microsegundos monotónicos (apto para señales)
+{
+   struct timespec T;
+   clock_gettime(CLOCK_MONOTONIC, &T);
+   return (unsigned long)(T.tv_sec * 1000000ULL + T.tv_nsec / 1000);
+}
+
+static float Medir()
+{
+   if (Lecturas < Instantes.size()) {
+      Instantes[Lecturas] = RelojReal();
+      Lecturas = Lecturas + 1;
+   }
+   return Planta.Salida();
+}
+
+static void Actuar(float SALIDA)
+{
+   Planta.Simular(SALIDA, Periodo);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static uint32_t Azar = 12345;
+
+static void TareaFondo(unsigned long CARGA)
+// Lo que hace loop() además del lazo: ocupa la CPU entre 0 y CARGA microsegundos.
+{
+   Azar ^= Azar << 13;  Azar ^= Azar >> 17;  Azar ^= Azar << 5;
+   unsigned long Duracion = CARGA ? Azar % (CARGA + 1) : 0;
+   unsigned long Inicio   = RelojReal();
+   while (RelojReal() - Inicio < Duracion) {
+   }
+}
+
+static void * HiloCarga(void *)
+{
+   sigset_t Senales;
+   sigemptyset(&Senales);
+   sigaddset(&Senales, SIGRTMIN);
+   pthread_sigmask(SIG_BLOCK, &Senales, 0);
+   volatile unsigned long Cuenta = 0;
+   while (!Terminar) Cuenta = Cuenta + 1;
+   return 0;
+}
+
+static void ManejadorTimer(int)
+{
+   Lazo->Tic();
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static void PrepararLazo(controlPID * NUEVO)
+{
+   Configuracion = pid_config_s();
+   Configuracion.Kp = 2;  Configuracion.Ti = 0.5f;  Configuracion.Td = 0.02f;
+   Configuracion.LimiteSuperior = 5;  Configuracion.CompensarIntegral = true;
+   Configuracion.Objetivo = 1;
+   PID = NUEVO;
+   PID->PeriodoFijo(Periodo);
+   PID->Configurar(&Configuracion);
+   Planta.Reiniciar(0);
+   Lecturas = 0;
+}
+
+static void CambiarObjetivo(unsigned long VUELTA)
+// Con el timer en marcha el controlador no se lee desde aquí: se parte de la copia propia.
+{
+   Configuracion.Objetivo = (VUELTA & 1) ? 2 : 1;
+   PID->Reconfigurar(&Configuracion);
+}
+
+static void Informar(const char * MODO, double SEGUNDOS)
+{
+   size_t N = Lecturas;
+   std::vector<long> Jitter;
+   long RetrasoMaximo = 0;
+   for (size_t i=1; i<N; i++) {
+      long Intervalo = long(Instantes[i] - Instantes[i-1]);
+      Jitter.push_back(labs(Intervalo - long(Periodo)));
+      long Retraso = long(Instantes[i] - (Instantes[0] + i * Periodo));
+      RetrasoMaximo = std::max(RetrasoMaximo, Retraso);
+   }
+   if (Jitter.empty()) {
+      printf("%-8s sin muestras\n", MODO);
+      return;
+   }
+   std::sort(Jitter.begin(), Jitter.end());
+   double Suma = 0;
+   for (long J : Jitter) Suma += J;
+   double Medio    = double(Instantes[N-1] - Instantes[0]) / (N-1);
+   size_t Perdidos = size_t(SEGUNDOS * 1e6 / Periodo) > N ? size_t(SEGUNDOS * 1e6 / Periodo) - N
+                                                          : 0;
+   printf("%-8s %9zu %9zu %10.2f %9.1f %9ld %9ld %11ld\n", MODO, N, Perdidos, Medio,
+          Suma / Jitter.size(), Jitter[Jitter.size() * 99 / 100], Jitter.back(), RetrasoMaximo);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static void Uso()
+{
+   fprintf(stderr, "Uso: latencia_pid [--periodo US] [--segundos S] [--carga US]"
+                   " [--hilos-carga N]\n");
+   exit(1);
+}
+
+int main(int argc, char ** argv)
+{
+   double        Segundos = 2;
+   unsigned long Carga    = 3000;
+   int           Hilos    = 0;
+   for (int i=1; i<argc; i++) {
+      if      (i+1 >= argc)                       Uso();
+      else if (!strcmp(argv[i], "--periodo"))     Periodo = strtoul(argv[++i], 0, 10);
+      else if (!strcmp(argv[i], "--segundos"))    Segundos = atof(argv[++i]);
+      else if (!strcmp(argv[i], "--carga"))       Carga = strtoul(argv[++i], 0, 10);
+      else if (!strcmp(argv[i], "--hilos-carga")) Hilos = atoi(argv[++i]);
+      else Uso();
+   }
+   if (Periodo == 0 || Segundos <= 0) Uso();
+   Instantes.resize(size_t(Segundos * 1e6 / Periodo) + 16);
+
+   // Los hilos de carga heredan la señal bloqueada; sólo el principal la atiende.
+   sigset_t Senales;
+   sigemptyset(&Senales);
+   sigaddset(&Senales, SIGRTMIN);
+   pthread_sigmask(SIG_BLOCK, &Senales, 0);
+   std::vector<pthread_t> HilosCarga(Hilos);
+   for (pthread_t & H : HilosCarga) pthread_create(&H, 0, HiloCarga, 0);
+   pthread_sigmask(SIG_UNBLOCK, &Senales, 0);
+
+   printf("Periodo %lu us, tareas de fondo de 0 a %lu us, %d hilos de carga, %.1f s por modo\n",
+          Periodo, Carga, Hilos, Segundos);
+   printf("modo      muestras  perdidas  periodo us  jitter us  p99 us    max us  retraso us\n");
+
+   // 1) Sondeo con el planificador ---------------------------------------------------------------
+   {
+      controlPID      Controlador;
+      planificadorPID Planificador;
+      PrepararLazo(&Controlador);
+      unsigned long Inicio = RelojReal();
+      Planificador.Agregar(&Controlador, Medir, Actuar, Periodo, 0);
+      unsigned long Vuelta = 0;
+      while (RelojReal() - Inicio < Segundos * 1e6) {
+         Planificador.Ejecutar(RelojReal());
+         TareaFondo(Carga);
+         if (++Vuelta % 64 == 0) CambiarObjetivo(Vuelta / 64);
+      }
+      Informar("sondeo", Segundos);
+   }
+
+   // 2) Timer POSIX y señal ----------------------------------------------------------------------
+   {
+      controlPID      Controlador;
+      interrupcionPID Interrupcion(&Controlador, Medir, Actuar, Periodo);
+      PrepararLazo(&Controlador);
+      Lazo = &Interrupcion;
+      Interrupcion.Reloj(RelojReal);
+
+      struct sigaction Accion;
+      memset(&Accion, 0, sizeof(Accion));
+      Accion.sa_handler = ManejadorTimer;
+      Accion.sa_flags   = SA_RESTART;
+      sigaction(SIGRTMIN, &Accion, 0);
+      timer_t           Timer;
+      struct sigevent   Evento;
+      memset(&Evento, 0, sizeof(Evento));
+      Evento.sigev_notify = SIGEV_SIGNAL;
+      Evento.sigev_signo  = SIGRTMIN;
+      timer_create(CLOCK_MONOTONIC, &Evento, &Timer);
+      struct itimerspec Programa;
+      Programa.it_value.tv_sec     = Periodo / 1000000;
+      Programa.it_value.tv_nsec    = (Periodo % 1000000) * 1000;
+      Programa.it_interval         = Programa.it_value;
+
+      Interrupcion.Iniciar();
+      timer_settime(Timer, 0, &Programa, 0);
+      unsigned long Inicio = RelojReal();
+      unsigned long Vuelta = 0;
+      pid_interrupcion_info_s Info;
+      while (RelojReal() - Inicio < Segundos * 1e6) {
+         TareaFondo(Carga);
+         Interrupcion.Leer(&Info);
+         if (++Vuelta % 64 == 0) CambiarObjetivo(Vuelta / 64);
+      }
+      Interrupcion.Detener();
+      timer_delete(Timer);
+      Informar("timer", Segundos);
+      Interrupcion.Leer(&Info);
+      printf("   Tic(): duracion maxima %lu us, latencia maxima de la señal %lu us, "
+             "%lu desbordes, medicion final %.3f\n", Info.DuracionMaxima, Info.LatenciaMaxima,
+             Info.Desbordes, Info.Lazo.UltimaMedicion);
+   }
+
+   Terminar = true;
+   for (pthread_t & H : HilosCarga) pthread_join(H, 0);
+   return 0;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/latencia_pid.cpp
+**************************************************************************************************/
@@ -0,0 +1,79 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/medicion.cpp
+* Breve:      Implementación de las herramientas de medición. Ver host/medicion.h.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "medicion.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+contadorInstrucciones::contadorInstrucciones()
+{
+   struct perf_event_attr Atributos;
+   memset(&Atributos, 0, sizeof(Atributos));
+   Atributos.type           = PERF_TYPE_HARDWARE;
+   Atributos.size           = sizeof(Atributos);
+   Atributos.config         = PERF_COUNT_HW_INSTRUCTIONS;
+   Atributos.disabled       = 1;
+   Atributos.exclude_kernel = 1;
+   Atributos.exclude_hv     = 1;
+   Descriptor = syscall(__NR_perf_event_open, &Atributos, 0, -1, -1, 0);
+}
+
+contadorInstrucciones::~contadorInstrucciones()
+{
+   if (Descriptor>=0) close(Descriptor);
+}
+
+bool contadorInstrucciones::Disponible() const
+{
+   return Descriptor>=0;
+}
+
+void contadorInstrucciones::Iniciar()
+{
+   if (Descriptor<0) return;
+   ioctl(Descriptor, PERF_EVENT_IOC_RESET, 0);
+   ioctl(Descriptor, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+uint64_t contadorInstrucciones::Detener()
+{
+   uint64_t Cuenta = 0;
+   if (Descriptor<0) return 0;
+   ioctl(Descriptor, PERF_EVENT_IOC_DISABLE, 0);
+   if (read(Descriptor, &Cuenta, sizeof(Cuenta)) != sizeof(Cuenta)) Cuenta = 0;
+   return Cuenta;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+double SegundosMonotonicos()
+{
+   struct timespec T;
+   clock_gettime(CLOCK_MONOTONIC, &T);
+   return T.tv_sec + T.tv_nsec*1e-9;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void ImprimirMedicion(const char * NOMBRE, medicion_s MEDICION)
+{
+   if (MEDICION.InstruccionesPorLlamada >= 0) {
+      printf("%-44s %9.2f ns/llamada %9.1f instr/llamada\n", 
+             NOMBRE, MEDICION.NsPorLlamada, MEDICION.InstruccionesPorLlamada);
+   } else {
+      printf("%-44s %9.2f ns/llamada %9s instr/llamada\n", NOMBRE, MEDICION.NsPorLlamada, "n/d");
+   }
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/medicion.cpp
+**************************************************************************************************/
@@ -0,0 +1,64 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/medicion.h
+* Breve:      Herramientas de medición de rendimiento para los programas de PC: tiempo por
+*             llamada (ns) y, si el sistema lo permite, instrucciones por llamada mediante los
+*             contadores de hardware de Linux (perf_event_open).
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef MEDICION_H
+#define MEDICION_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+struct medicion_s {
+   double NsPorLlamada;             // Tiempo medio por llamada, en nanosegundos
+   double InstruccionesPorLlamada;  // Instrucciones medias por llamada (<0 si no disponible)
+};
+
+class contadorInstrucciones               // Contador de instrucciones de usuario (perf_event)
+{
+   private:
+   int Descriptor;                        // -1 si el sistema no permite leer el contador
+   
+   public:
+   contadorInstrucciones();
+   ~contadorInstrucciones();
+   bool Disponible() const;
+   void Iniciar();
+   uint64_t Detener();                    // Devuelve instrucciones desde Iniciar()
+};
+
+double SegundosMonotonicos();             // Reloj monotónico del sistema, en segundos
+
+// Ejecuta FUNCION(i) ITERACIONES veces y devuelve el costo medio por llamada.
+// FUNCION recibe el número de iteración para que el optimizador no pueda eliminar el trabajo.
+template <typename F>
+medicion_s Medir(F FUNCION, unsigned long ITERACIONES)
+{
+   static contadorInstrucciones Contador;
+   medicion_s Resultado;
+   
+   for (unsigned long i=0; i<ITERACIONES/16; i++) FUNCION(i);  // Calentamiento
+   
+   Contador.Iniciar();
+   double Inicio = SegundosMonotonicos();
+   for (unsigned long i=0; i<ITERACIONES; i++) FUNCION(i);
+   double Fin = SegundosMonotonicos();
+   uint64_t Instrucciones = Contador.Detener();
+   
+   Resultado.NsPorLlamada = (Fin-Inicio) * 1e9 / ITERACIONES;
+   Resultado.InstruccionesPorLlamada = Contador.Disponible() ? double(Instrucciones)/ITERACIONES 
+                                                             : -1;
+   return Resultado;
+}
+
+void ImprimirMedicion(const char * NOMBRE, medicion_s MEDICION);
+
+#endif // MEDICION_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
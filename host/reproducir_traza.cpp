@@ -0,0 +1,175 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/reproducir_traza.cpp
+* Breve:      Reproduce en la PC una traza grabada con grabadorPID (ver control-pid-grabador_sca.h).
+*             Mapea el archivo en memoria y lo recorre lo más rápido posible: aplica cada cambio
+*             de configuración y ejecuta controlPID::ControlarEn() con el mismo tiempo, medición y
+*             objetivo de cada muestra, comparando la salida con la grabada.
+*             Con --kp, --ti o --td se reemplazan esas ganancias en cada configuración, para
+*             evaluar una sintonía nueva sobre datos reales.
+*             Los tiempos de la traza son el micros() de 32 bits de la placa, que desborda cada
+*             unos 71 minutos; en la PC unsigned long es de 64 bits, así que se desenvuelven
+*             sumando las diferencias de 32 bits, igual que las calcula la placa.
+*             Sin --kp, --ti ni --td termina con código 2 si alguna salida difiere de la grabada.
+*             Una traza del modo por eventos (banda distinta de 0) sólo se reproduce compilado
+*             con PID_EVENTOS (reproducir_eventos); si no, avisa y termina con código 2.
+* Uso:        reproducir_traza TRAZA [--csv] [--kp X] [--ti X] [--td X] > pasos.csv
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+#include "control-pid-grabador_sca.h"
+#include "medicion.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static void Uso()
+{
+   fprintf(stderr, "Uso: reproducir_traza TRAZA [--csv] [--kp X] [--ti X] [--td X]\n");
+   exit(1);
+}
+
+int main(int argc, char ** argv)
+{
+   const char * Archivo = NULL;
+   bool  CSV = false;
+   bool  CambiarKp = false, CambiarTi = false, CambiarTd = false;
+   float Kp = 0, Ti = 0, Td = 0;
+   
+   for (int i=1; i<argc; i++) {
+      if      (!strcmp(argv[i], "--csv"))           CSV = true;
+      else if (!strcmp(argv[i], "--kp") && i+1<argc) { CambiarKp = true; Kp = atof(argv[++i]); }
+      else if (!strcmp(argv[i], "--ti") && i+1<argc) { CambiarTi = true; Ti = atof(argv[++i]); }
+      else if (!strcmp(argv[i], "--td") && i+1<argc) { CambiarTd = true; Td = atof(argv[++i]); }
+      else if (argv[i][0] != '-' && !Archivo)       Archivo = argv[i];
+      else Uso();
+   }
+   if (!Archivo) Uso();
+   
+   // Mapeo del archivo completo en memoria
+   int Descriptor = open(Archivo, O_RDONLY);
+   struct stat Estado;
+   if (Descriptor < 0 || fstat(Descriptor, &Estado) < 0) {
+      fprintf(stderr, "No se pudo abrir %s\n", Archivo);
+      return 1;
+   }
+   size_t Tamanio = Estado.st_size;
+   const uint8_t * Datos = NULL;
+   if (Tamanio > 0) {
+      void * Mapa = mmap(NULL, Tamanio, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+      if (Mapa == MAP_FAILED) {
+         fprintf(stderr, "No se pudo mapear %s\n", Archivo);
+         return 1;
+      }
+      madvise(Mapa, Tamanio, MADV_SEQUENTIAL);
+      Datos = (const uint8_t *) Mapa;
+   }
+   
+   controlPID    PID(PID_SIN_SALIDA);
+   pid_evento_s  Evento;
+   pid_info_s    Info;
+   unsigned long Muestras = 0, Distintas = 0, Configuraciones = 0, BytesInvalidos = 0;
+   double        DiferenciaMaxima = 0;
+   uint32_t      TiempoGrabado = 0;       // Último tiempo de la traza (32 bits)
+   unsigned long Tiempo = 0;              // El mismo sin desbordes, para ControlarEn()
+   bool          Primera = true;
+   bool          SinEventos = false;      // La traza usa una banda y no hay PID_EVENTOS
+   
+   if (CSV) {
+      printf("Tiempo,Medicion,Objetivo,Salida,ComponenteProporcional,ComponenteIntegral,"
+             "ComponenteDerivativo,Compensacion,SalidaGrabada,Diferencia\n");
+   }
+   double Inicio = SegundosMonotonicos();
+   size_t Posicion = 0;
+   while (Posicion < Tamanio) {
+      uint8_t Largo = LeerTramaTraza(&Datos[Posicion], Tamanio - Posicion, &Evento);
+      if (Largo == 0) {
+         Posicion++;                      // Basura o trama dañada: se busca el próximo sincronismo
+         BytesInvalidos++;
+         continue;
+      }
+      Posicion += Largo;
+      
+      switch (Evento.Tipo) {
+         case TRAZA_CONFIGURACION:
+            if (CambiarKp) Evento.Configuracion.Config.Kp = Kp;
+            if (CambiarTi) Evento.Configuracion.Config.Ti = Ti;
+            if (CambiarTd) Evento.Configuracion.Config.Td = Td;
+            PID.PeriodoFijo(Evento.Configuracion.Periodo);
+            PID.Configurar(&Evento.Configuracion.Config);
+            Configuraciones++;
+            break;
+         case TRAZA_RECONFIGURACION:
+            if (CambiarKp) Evento.Configuracion.Config.Kp = Kp;
+            if (CambiarTi) Evento.Configuracion.Config.Ti = Ti;
+            if (CambiarTd) Evento.Configuracion.Config.Td = Td;
+            PID.Reconfigurar(&Evento.Configuracion.Config);
+            Configuraciones++;
+            break;
+         case TRAZA_PERIODO:
+            PID.PeriodoFijo(Evento.Configuracion.Periodo);
+            Configuraciones++;
+            break;
+         case TRAZA_APAGADO:
+            PID.Apagar();
+            break;
+         case TRAZA_EVENTOS:
+#if PID_EVENTOS
+            PID.Eventos(Evento.Eventos.Banda, Evento.Eventos.Silencio);
+#else
+            SinEventos = SinEventos || Evento.Eventos.Banda > 0;
+#endif
+            Configuraciones++;
+            break;
+         case TRAZA_MUESTRA: {
+            uint32_t Actual = uint32_t(Evento.Muestra.Tiempo);
+            Tiempo        = Primera ? Actual : Tiempo + uint32_t(Actual - TiempoGrabado);
+            TiempoGrabado = Actual;
+            Primera       = false;
+            float  Salida     = PID.ControlarEn(Tiempo, Evento.Muestra.Medicion,
+                                                Evento.Muestra.Objetivo);
+            double Diferencia = double(Salida) - Evento.Muestra.Salida;
+            Muestras++;
+            if (Salida != Evento.Muestra.Salida) Distintas++;
+            DiferenciaMaxima = fmax(DiferenciaMaxima, fabs(Diferencia));
+            if (CSV) {
+               PID.Leer(&Info);
+               printf("%lu,%g,%g,%g,%g,%g,%g,%g,%g,%g\n", Evento.Muestra.Tiempo, 
+                      Evento.Muestra.Medicion, Evento.Muestra.Objetivo, Salida, 
+                      Info.ComponenteProporcional, Info.ComponenteIntegral, 
+                      Info.ComponenteDerivativo, Info.Compensacion, Evento.Muestra.Salida,
+                      Diferencia);
+            }
+            break;
+         }
+      }
+   }
+   double Segundos = SegundosMonotonicos() - Inicio;
+   
+   fprintf(stderr, "%lu muestras, %lu configuraciones, %lu bytes invalidos, %.3f s "
+                   "(%.0f muestras/s)\n", Muestras, Configuraciones, BytesInvalidos, Segundos,
+                   Segundos > 0 ? Muestras/Segundos : 0);
+   fprintf(stderr, "%lu salidas distintas de las grabadas, diferencia maxima %g\n", 
+           Distintas, DiferenciaMaxima);
+   if (SinEventos) {
+      fprintf(stderr, "la traza usa el modo por eventos: reproducirla con reproducir_eventos "
+                      "(compilado con PID_EVENTOS)\n");
+   }
+   if (Datos) munmap((void *) Datos, Tamanio);
+   close(Descriptor);
+   bool Sintonia = CambiarKp || CambiarTi || CambiarTd;
+   return ((Distintas > 0 && !Sintonia) || SinEventos) ? 2 : 0;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/reproducir_traza.cpp
+**************************************************************************************************/
@@ -0,0 +1,137 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/simulador_pid.cpp
+* Breve:      Implementación del simulador en lazo cerrado. Ver host/simulador_pid.h.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "simulador_pid.h"
+#include "medicion.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#define BLOQUE_CANDIDATOS 64      // Candidatos que toma cada hilo por vez
+
+simulacion_s SimulacionPredeterminada()
+{
+   simulacion_s Sim;
+   Sim.Modelo   = MODELO_PRIMER_ORDEN;
+   Sim.Ganancia = 1;              // MODELO_RESISTENCIA
+   Sim.Tau      = 1 * 2;          // MODELO_RESISTENCIA * MODELO_CAPACIDAD
+   Sim.Retardo  = 0;
+   Sim.Zeta     = 1;
+   Sim.Inicial  = 0;
+   Sim.Objetivo = 10;
+   Sim.Periodo  = 500000;         // TIEMPO_MUESTREO = 500 ms
+   Sim.Duracion = 60;
+   Sim.Banda    = 0.02f;
+   return Sim;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+metricas_s Simular(const pid_config_s * CANDIDATO, const simulacion_s * SIM)
+{
+   metricas_s   M = {};
+   pid_config_s Config = *CANDIDATO;
+   controlPID   PID(PID_SIN_SALIDA);
+   
+   plantaPrimerOrden        PrimerOrden(SIM->Ganancia, SIM->Tau, SIM->Inicial);
+   plantaPrimerOrdenRetardo ConRetardo(SIM->Ganancia, SIM->Tau, SIM->Retardo, SIM->Inicial);
+   plantaSegundoOrden       SegundoOrden(SIM->Ganancia, 1 / SIM->Tau, SIM->Zeta, SIM->Inicial);
+   planta * Planta = &PrimerOrden;
+   if (SIM->Modelo == MODELO_RETARDO)       Planta = &ConRetardo;
+   if (SIM->Modelo == MODELO_SEGUNDO_ORDEN) Planta = &SegundoOrden;
+   
+   float T         = SIM->Periodo / 1e6f;
+   long  Pasos     = long(SIM->Duracion / T);
+   float Escalon   = fabsf(SIM->Objetivo - SIM->Inicial);
+   float Banda     = SIM->Banda * Escalon;
+   float Medicion  = SIM->Inicial;
+   float Extremo   = SIM->Inicial;
+   bool  Subida    = SIM->Objetivo >= SIM->Inicial;
+   
+   Config.Objetivo = SIM->Objetivo;
+   PID.PeriodoFijo(SIM->Periodo);
+   PID.Configurar(&Config);
+   bool Limitada = Config.LimiteSuperior != Config.LimiteInferior;
+   
+   for (long k=0; k<Pasos; k++) {
+      float Error  = SIM->Objetivo - Medicion;
+      float Salida = PID.Controlar(Medicion);
+      
+      M.IAE += fabsf(Error) * T;
+      M.ISE += Error * Error * T;
+      if (fabsf(Error) > Banda) {
+         M.TiempoEstablecimiento = (k+1) * T;
+      }
+      if (Limitada && (Salida >= Config.LimiteSuperior || Salida <= Config.LimiteInferior)) {
+         M.TiempoSaturado += T;
+      }
+      
+      // La planta mantiene la salida durante el período:
+      Medicion = Planta->Simular(Salida, SIM->Periodo);
+      Extremo  = Subida ? fmaxf(Extremo, Medicion) : fminf(Extremo, Medicion);
+   }
+   if (Escalon > 0) {
+      M.Sobrepico = fmaxf(0, (Subida ? Extremo - SIM->Objetivo : SIM->Objetivo - Extremo)) 
+                  / Escalon * 100;
+   }
+   return M;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+double SimularCandidatos(const pid_config_s * CANDIDATOS, metricas_s * RESULTADOS, 
+                         size_t CANTIDAD, const simulacion_s * SIM, unsigned int HILOS)
+{
+   std::atomic<size_t>      Siguiente(0);
+   std::vector<std::thread> Hilos;
+   
+   if (HILOS==0) HILOS = std::thread::hardware_concurrency();
+   if (HILOS==0) HILOS = 1;
+   
+   auto Trabajar = [&]() {
+      size_t Inicio;
+      while ( (Inicio = Siguiente.fetch_add(BLOQUE_CANDIDATOS)) < CANTIDAD ) {
+         size_t Fin = (Inicio+BLOQUE_CANDIDATOS < CANTIDAD) ? Inicio+BLOQUE_CANDIDATOS : CANTIDAD;
+         for (size_t i=Inicio; i<Fin; i++) {
+            RESULTADOS[i] = Simular(&CANDIDATOS[i], SIM);
+         }
+      }
+   };
+   
+   double Comienzo = SegundosMonotonicos();
+   for (unsigned int h=1; h<HILOS; h++) Hilos.emplace_back(Trabajar);
+   Trabajar();
+   for (std::thread & H : Hilos) H.join();
+   return SegundosMonotonicos() - Comienzo;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool LeerCandidatos(const char * ARCHIVO, std::vector<pid_config_s> * CANDIDATOS)
+{
+   FILE * F = fopen(ARCHIVO, "r");
+   char   Linea[256];
+   if (!F) return false;
+   while (fgets(Linea, sizeof(Linea), F)) {
+      pid_config_s C = {};
+      int Compensar = 0;
+      if (sscanf(Linea, "%f,%f,%f,%f,%f,%d", &C.Kp, &C.Ti, &C.Td, 
+                 &C.LimiteInferior, &C.LimiteSuperior, &Compensar) == 6) {
+         C.CompensarIntegral = Compensar != 0;
+         CANDIDATOS->push_back(C);
+      }
+   }
+   fclose(F);
+   return true;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/simulador_pid.cpp
+**************************************************************************************************/
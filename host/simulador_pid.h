@@ -0,0 +1,65 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/simulador_pid.h
+* Breve:      Simulación en lazo cerrado de controlPID con una planta, más rápida que el tiempo
+*             real, y evaluación en paralelo de muchos candidatos de sintonía.
+*             El controlador usa PeriodoFijo(), así que no depende del reloj. La planta sale de
+*             control-pid-planta_sca (primer orden, con retardo o segundo orden), que calcula su
+*             transición discreta una sola vez para el período de la simulación.
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#ifndef SIMULADOR_PID_H
+#define SIMULADOR_PID_H
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+#include "control-pid-planta_sca.h"
+
+#include <stddef.h>
+#include <vector>
+
+#define MODELO_PRIMER_ORDEN  0            // K / (Tau s + 1)
+#define MODELO_RETARDO       1            // K e^(-Retardo s) / (Tau s + 1)
+#define MODELO_SEGUNDO_ORDEN 2            // K / (Tau^2 s^2 + 2 Zeta Tau s + 1)
+
+struct simulacion_s {
+   uint8_t       Modelo;                  // MODELO_...
+   float         Ganancia;                // Ganancia estática de la planta (R en el ejemplo)
+   float         Tau;                     // Constante de tiempo de la planta, en segundos
+   float         Retardo;                 // Tiempo muerto (MODELO_RETARDO), en segundos
+   float         Zeta;                    // Amortiguamiento (MODELO_SEGUNDO_ORDEN)
+   float         Inicial;                 // Salida inicial de la planta
+   float         Objetivo;                // Escalón de objetivo aplicado en t=0
+   unsigned long Periodo;                 // Período de muestreo, en microsegundos
+   float         Duracion;                // Duración simulada, en segundos
+   float         Banda;                   // Banda de establecimiento, fracción del escalón (0.02)
+};
+
+struct metricas_s {
+   float IAE;                             // Integral del error absoluto
+   float ISE;                             // Integral del error cuadrático
+   float Sobrepico;                       // Sobrepico en % del escalón (0 si no pasa el objetivo)
+   float TiempoEstablecimiento;           // Último instante fuera de la banda, en segundos
+   float TiempoSaturado;                  // Tiempo con la salida en un límite, en segundos
+};
+
+simulacion_s SimulacionPredeterminada();  // La planta y el muestreo de Ejemplo_simulacion
+
+metricas_s Simular(const pid_config_s * CANDIDATO, const simulacion_s * SIM);
+                                          // Simula un candidato y devuelve sus métricas
+
+double SimularCandidatos(const pid_config_s * CANDIDATOS, metricas_s * RESULTADOS, 
+                         size_t CANTIDAD, const simulacion_s * SIM, unsigned int HILOS);
+                                          // Simula CANTIDAD candidatos repartidos en HILOS 
+                                          // hilos (0: todos los núcleos). Devuelve los segundos
+                                          // que tardó.
+
+bool LeerCandidatos(const char * ARCHIVO, std::vector<pid_config_s> * CANDIDATOS);
+                                          // Agrega las líneas Kp,Ti,Td,LimiteInferior,
+                                          // LimiteSuperior,CompensarIntegral de ARCHIVO.
+
+#endif // SIMULADOR_PID_H
+
+/******************* FIN DE ARCHIVO **************************************************************/
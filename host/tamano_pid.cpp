@@ -0,0 +1,31 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/tamano_pid.cpp
+* Breve:      Instancia controlPIDFijo en varias estructuras para comparar el tamaño de su
+*             ControlarEn(), donde queda todo el cálculo, con el de controlPID::ControlarEn()
+*             más lo que ésta llama en cada muestra (control-pid_sca.o).
+* Uso:        make -C host tamano
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "control-pid-fijo_sca.h"
+
+#define PIN_PWM    3
+#define PERIODO_US 1000
+
+struct sintoniaPI  { static constexpr float Kp = 5, Ti = 4, Td = 0,    LimiteSuperior = 20, LimiteInferior = 0; };
+struct sintoniaPID { static constexpr float Kp = 5, Ti = 4, Td = 0.5f, LimiteSuperior = 20, LimiteInferior = 0; };
+
+template class controlPIDFijo<PID_ESTRUCTURA_P, PID_SIN_SALIDA, PERIODO_US>;
+template class controlPIDFijo<PID_ESTRUCTURA_PI | PID_LIMITAR | PID_ANTIENROLE, PIN_PWM, PERIODO_US>;
+template class controlPIDFijo<PID_ESTRUCTURA_PID | PID_LIMITAR | PID_ANTIENROLE, PIN_PWM, PERIODO_US>;
+template class controlPIDFijo<PID_ESTRUCTURA_PID | PID_LIMITAR | PID_ANTIENROLE, PIN_PWM, 0>;
+template class controlPIDFijo<PID_ESTRUCTURA_PI | PID_LIMITAR | PID_ANTIENROLE, PIN_PWM, PERIODO_US,
+                              sintoniaPI>;
+template class controlPIDFijo<PID_ESTRUCTURA_PID | PID_LIMITAR | PID_ANTIENROLE, PIN_PWM, PERIODO_US,
+                              sintoniaPID>;
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/tamano_pid.cpp
+**************************************************************************************************/
@@ -0,0 +1,385 @@
+/**************************************************************************************************
+* Control PID - SCA UNDAV
+***************************************************************************************************
+* Archivo:    host/verificar_pid.cpp
+* Breve:      Verificaciones de la semántica del controlador que no debe cambiar, para correr con
+*             cada compilación ("make -C host" las ejecuta). Informa cada una y termina con
+*             código 1 si alguna falla:
+*             - controlPID, controlPIDT, controlPIDFijo y controlPIDProgramado dan las mismas
+*               salidas con Controlar() (reloj) que con ControlarEn() (tiempo dado).
+*             - Dan las mismas salidas si el reloj desborda (pasa por ULONG_MAX+1: 2^32 en la
+*               placa) a mitad de la corrida que si no desborda.
+*             - Reconfigurar() llamado muchas veces entre dos muestras aplica la última.
+*             - interrupcionPID después de Detener() e Iniciar() da las mismas salidas que uno
+*               recién creado.
+*             - planificadorPID con Ejecutar(AHORA) y un reloj que no es micros() cuenta las
+*               fases desde ese reloj.
+*             - Compilado con PID_EVENTOS y PID_ESTADISTICAS (verificar_eventos): después de
+*               muestras omitidas, el derivativo es el mismo que sin banda de eventos, y las
+*               estadísticas cuentan las llamadas omitidas y sus intervalos.
+*             Además escribe en ARCHIVO la traza de grabadorPID de un lazo con período medido
+*             cuyo micros() de 32 bits desborda a mitad de la grabación, para que
+*             host/reproducir_traza verifique que la reproduce idéntica (con PID_EVENTOS, con
+*             una banda de eventos, para host/reproducir_eventos).
+* Uso:        verificar_pid [--traza ARCHIVO]
+* Fecha:      mayo 2025
+**************************************************************************************************/
+
+#include "Arduino.h"
+#include "control-pid_sca.h"
+#include "control-pid-tipo_sca.h"
+#include "control-pid-fijo_sca.h"
+#include "control-pid-programado_sca.h"
+#include "control-pid-grabador_sca.h"
+#include "control-pid-interrupcion_sca.h"
+#include "control-pid-planificador_sca.h"
+#include "control-pid-planta_sca.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+class archivoSerie : public Print         // Puerto serie que escribe en un archivo
+{
+   public:
+   FILE * Archivo;
+   archivoSerie(FILE * ARCHIVO) : Archivo(ARCHIVO) {}
+   size_t write(uint8_t BYTE) { return fwrite(&BYTE, 1, 1, Archivo); }
+   size_t write(const uint8_t * DATOS, size_t LARGO) { return fwrite(DATOS, 1, LARGO, Archivo); }
+   int availableForWrite() { return 255; }
+};
+
+static uint32_t Azar = 2463534242u;
+
+static unsigned long Variacion(unsigned long MAXIMO)   // 0 a MAXIMO, reproducible
+{
+   Azar ^= Azar << 13;  Azar ^= Azar >> 17;  Azar ^= Azar << 5;
+   return Azar % (MAXIMO + 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+template <class C>
+static bool Comparar(const char * NOMBRE, C & A, C & B, unsigned long INICIO_A,
+                     unsigned long INICIO_B, bool RELOJ_A)
+// Las mismas mediciones y los mismos intervalos (con jitter) para A y B, con tiempos que parten
+// de INICIO_A y de INICIO_B. A usa Controlar() con el reloj virtual si RELOJ_A, o ControlarEn();
+// B siempre ControlarEn(). Las salidas deben ser idénticas.
+{
+   pid_config_s Config = {};
+   Config.Objetivo = 1;  Config.Kp = 3;  Config.Ti = 0.8f;  Config.Td = 0.05f;
+   Config.LimiteSuperior = 5;  Config.CompensarIntegral = true;
+   pid_config_s Copia = Config;
+   A.Configurar(&Config);
+   B.Configurar(&Copia);
+
+   unsigned long TA = INICIO_A, TB = INICIO_B;
+   bool Iguales = true;
+   for (int i=0; i<3000; i++) {
+      unsigned long Paso = 9000 + Variacion(2000);
+      TA += Paso;
+      TB += Paso;
+      float Medicion = 1 + 0.8f * sinf(i * 0.01f) + 0.001f * Variacion(100);
+      RelojVirtual = TA;
+      auto SalidaA = RELOJ_A ? A.Controlar(Medicion) : A.ControlarEn(TA, Medicion);
+      auto SalidaB = B.ControlarEn(TB, Medicion);
+      Iguales = Iguales && memcmp(&SalidaA, &SalidaB, sizeof(SalidaA)) == 0;
+   }
+   printf("%-48s %s\n", NOMBRE, Iguales ? "identica" : "FALLA");
+   return Iguales;
+}
+
+template <class C>
+static bool VerificarTiempos(const char * NOMBRE, C & A, C & B)
+{
+   // Desde 15 s antes del desborde: cruza ULONG_MAX+1 a mitad de las 3000 muestras.
+   const unsigned long Desborde = ULONG_MAX - 15000000UL;
+   char Nombre[64];
+   bool Correcto = true;
+   snprintf(Nombre, sizeof(Nombre), "Controlar = ControlarEn, %s", NOMBRE);
+   Correcto = Comparar(Nombre, A, B, 1000, 1000, true) && Correcto;
+   snprintf(Nombre, sizeof(Nombre), "desborde del reloj, %s", NOMBRE);
+   Correcto = Comparar(Nombre, A, B, 1000, Desborde, false) && Correcto;
+   return Correcto;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+#if PID_EVENTOS
+static bool VerificarEventos(unsigned long PERIODO)
+// Con la medición en rampa la derivada es constante. En cada evaluación después de muestras
+// omitidas, el cambio del error desde la evaluación anterior dividido por el tiempo desde ella
+// debe dar el mismo derivativo que el controlador sin banda, que evalúa todas las muestras.
+{
+   pid_config_s Config = {};
+   Config.Objetivo = 1;  Config.Kp = 3;  Config.Td = 0.05f;
+   pid_config_s Copia = Config;
+   controlPID ConBanda, SinBanda;
+   ConBanda.PeriodoFijo(PERIODO);
+   SinBanda.PeriodoFijo(PERIODO);
+   ConBanda.Configurar(&Config);
+   SinBanda.Configurar(&Copia);
+   ConBanda.Eventos(0.0035f, 0);          // Omite tres de cada cuatro muestras
+   SinBanda.Eventos(0, 0);
+#if PID_ESTADISTICAS
+   ConBanda.ConfigurarEstadisticas(10000, 0);
+#endif
+
+   unsigned long Tiempo     = 0;
+   unsigned long Evaluadas  = 0;
+   bool          Iguales    = true;
+   for (int i=0; i<400; i++) {
+      Tiempo += PERIODO ? PERIODO : 9000 + Variacion(2000);
+      float         Medicion = 1e-7f * Tiempo;       // 0,001 cada 10 ms
+      unsigned long Antes    = ConBanda.EvaluacionesOmitidas();
+      RelojVirtual = Tiempo;              // Las estadísticas miden el intervalo con micros()
+      ConBanda.ControlarEn(Tiempo, Medicion);
+      SinBanda.ControlarEn(Tiempo, Medicion);
+      if (i == 0 || ConBanda.EvaluacionesOmitidas() != Antes) {
+         continue;
+      }
+      pid_info_s A, B;
+      ConBanda.Leer(&A);
+      SinBanda.Leer(&B);
+      Evaluadas++;
+      Iguales = Iguales && fabsf(A.ComponenteDerivativo - B.ComponenteDerivativo)
+                           <= 1e-3f * fabsf(B.ComponenteDerivativo);
+   }
+   bool Correcto = Iguales && ConBanda.EvaluacionesOmitidas() > 2 * Evaluadas;
+   printf("%-48s %s\n", PERIODO ? "derivada tras omitidas, periodo fijo"
+                                 : "derivada tras omitidas, periodo medido",
+          Correcto ? "identica" : "FALLA");
+#if PID_ESTADISTICAS
+   // Las llamadas omitidas también cuentan, así que todos los intervalos son de un período.
+   pid_estadisticas_s Estadisticas;
+   ConBanda.LeerEstadisticas(&Estadisticas);
+   bool Cuenta = Estadisticas.Llamadas == 400 && Estadisticas.FueraDeTolerancia == 0;
+   printf("%-48s %s\n", PERIODO ? "estadisticas con omitidas, periodo fijo"
+                                 : "estadisticas con omitidas, periodo medido",
+          Cuenta ? "correctas" : "FALLA");
+   Correcto = Correcto && Cuenta;
+#endif
+   return Correcto;
+}
+#endif
+
+//-------------------------------------------------------------------------------------------------
+
+static bool VerificarReconfigurar()
+// Muchas llamadas a Reconfigurar() entre dos muestras (más que las que cuenta la secuencia de 8
+// bits): se aplica la última.
+{
+   pid_config_s Config = {};
+   Config.Kp = 1;
+   controlPID PID;
+   PID.Configurar(&Config);
+   PID.ControlarEn(0, 0);
+   for (int i=1; i<=256; i++) {
+      Config.Objetivo = i;
+      PID.Reconfigurar(&Config);
+   }
+   bool Pendiente = PID.ReconfiguracionPendiente();
+   PID.ControlarEn(1000, 0);
+   pid_config_s Aplicada;
+   PID.Obtener(&Aplicada);
+   bool Correcto = Pendiente && !PID.ReconfiguracionPendiente() && Aplicada.Objetivo == 256;
+   printf("%-48s %s\n", "256 Reconfigurar() sin muestras", Correcto ? "aplicada" : "FALLA");
+   return Correcto;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static float MedirCero()
+{
+   return 0;
+}
+
+static bool VerificarPlanificador()
+// Ejecutar(AHORA) con un reloj propio que no es micros(): la fase de un lazo agregado antes de
+// arrancar se cuenta desde el primer AHORA, y la de uno agregado después desde el último, sin
+// períodos perdidos.
+{
+   controlPID      A(PID_SIN_SALIDA), B(PID_SIN_SALIDA);
+   planificadorPID Planificador;
+   RelojVirtual = 0;
+   Planificador.Agregar(&A, MedirCero, 0, 10000, 2500);
+   unsigned long Ahora = 3000000000UL;
+   bool Correcto = Planificador.Ejecutar(Ahora) == 2500;
+   Ahora += 2500;
+   Planificador.Ejecutar(Ahora);
+   Planificador.Agregar(&B, MedirCero, 0, 10000, 5000);
+   for (int i=0; i<100; i++) {
+      Ahora += Planificador.Ejecutar(Ahora);
+   }
+   pid_tarea_info_s InfoA, InfoB;
+   Planificador.Leer(0, &InfoA);
+   Planificador.Leer(1, &InfoB);
+   Correcto = Correcto && InfoA.PeriodosPerdidos == 0 && InfoB.PeriodosPerdidos == 0
+                       && InfoA.RetrasoMaximo == 0 && InfoB.RetrasoMaximo == 0
+                       && InfoB.Ejecuciones > 0;
+   printf("%-48s %s\n", "planificadorPID con Ejecutar(AHORA)", Correcto ? "a tiempo" : "FALLA");
+   return Correcto;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static unsigned long TicReinicio;
+static float         SalidasReinicio[300];
+
+static float MedirReinicio()
+{
+   return 0.5f + 0.3f * sinf(0.05f * TicReinicio);
+}
+
+static void ActuarReinicio(float SALIDA)
+{
+   SalidasReinicio[TicReinicio++] = SALIDA;
+}
+
+static void CorrerTics(interrupcionPID & LAZO)
+{
+   TicReinicio = 0;
+   LAZO.Iniciar();
+   while (TicReinicio < 300) {
+      RelojVirtual += LAZO.PeriodoTic();
+      LAZO.Tic();
+   }
+   LAZO.Detener();
+}
+
+static bool VerificarReinicio()
+// Iniciar() vuelve a contar los tics desde 0: después de Detener() el lazo reiniciado debe
+// comportarse como uno nuevo, sin un intervalo negativo que lleve el integral al límite.
+{
+   pid_config_s Config = {};
+   Config.Objetivo = 1;  Config.Kp = 3;  Config.Ti = 0.8f;  Config.Td = 0.05f;
+   Config.LimiteSuperior = 5;  Config.CompensarIntegral = true;
+
+   controlPID      PIDA(PID_SIN_SALIDA), PIDB(PID_SIN_SALIDA);
+   interrupcionPID A(&PIDA, MedirReinicio, ActuarReinicio, 10000);
+   interrupcionPID B(&PIDB, MedirReinicio, ActuarReinicio, 10000);
+   PIDA.Configurar(&Config);
+   PIDB.Configurar(&Config);
+
+   RelojVirtual = 0;
+   CorrerTics(A);
+   RelojVirtual += 2000000;                 // Detenido 2 s
+   CorrerTics(A);
+   float Reiniciado[300];
+   memcpy(Reiniciado, SalidasReinicio, sizeof(Reiniciado));
+   CorrerTics(B);
+
+   bool Correcto = memcmp(Reiniciado, SalidasReinicio, sizeof(Reiniciado)) == 0;
+   printf("%-48s %s\n", "interrupcionPID, Detener() e Iniciar()", Correcto ? "identica" : "FALLA");
+   return Correcto;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static bool GrabarTrazaDesborde(const char * ARCHIVO)
+// El reloj virtual de la PC es de 64 bits: el controlador calcula los intervalos como los
+// calcularía la placa, y la traza guarda los 32 bits bajos, que pasan por 0xFFFFFFFF a los 5 s.
+// Período con jitter, derivativo, un Reconfigurar() y un Apagar() con Configurar() en el medio.
+// Con PID_EVENTOS, además, una banda de eventos que omite muestras, grabada en la traza.
+{
+   FILE * Archivo = fopen(ARCHIVO, "wb");
+   if (!Archivo) {
+      printf("no se pudo crear %s\n", ARCHIVO);
+      return false;
+   }
+   archivoSerie      Puerto(Archivo);
+   controlPID        PID(PID_SIN_SALIDA);
+   plantaPrimerOrden Planta(2, 0.5f, 0);
+   pid_config_s      Config = {};
+   Config.Objetivo = 1;  Config.Kp = 3;  Config.Ti = 0.8f;  Config.Td = 0.05f;
+   Config.LimiteSuperior = 5;  Config.CompensarIntegral = true;
+
+   RelojVirtual = 0x100000000UL - 5000000UL;
+   PID.Configurar(&Config);
+   grabadorPID Grabador(&PID);
+#if PID_EVENTOS
+   Grabador.Eventos(0.01f, 100000);
+#endif
+   unsigned long Anterior = RelojVirtual;
+   float Medicion = 0;
+   for (int i=0; i<2000; i++) {
+      if (i == 700) {
+         Config.Objetivo = 2;  Config.Kp = 2.5f;
+         Grabador.Reconfigurar(&Config);
+      }
+      if (i == 1400) {
+         Grabador.Apagar();
+         Grabador.Configurar(&Config);
+      }
+      RelojVirtual += 9000 + Variacion(2000);
+      float Salida = Grabador.Controlar(Medicion);
+      Medicion = Planta.Simular(Salida, RelojVirtual - Anterior);
+      Anterior = RelojVirtual;
+      while (Grabador.Transmitir(Puerto) > 0) {
+      }
+   }
+   bool Cruzo = (RelojVirtual >> 32) != 0;
+#if PID_EVENTOS
+   Cruzo = Cruzo && PID.EvaluacionesOmitidas() > 0;
+#endif
+   fclose(Archivo);
+   printf("%-40s %s\n", "traza con desborde de micros()", Cruzo ? "grabada" : "FALLA");
+   return Cruzo && Grabador.Perdidos() == 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int main(int argc, char ** argv)
+{
+   const char * Traza = NULL;
+   for (int i=1; i<argc; i++) {
+      if (!strcmp(argv[i], "--traza") && i+1 < argc) {
+         Traza = argv[++i];
+      } else {
+         fprintf(stderr, "Uso: verificar_pid [--traza ARCHIVO]\n");
+         return 1;
+      }
+   }
+   static const pid_ganancias_s Tabla[] = { { 0, 4, 1.2f, 0.02f },
+                                             { 1, 3, 0.8f, 0.05f },
+                                             { 2, 2, 0,    0.08f } };
+   bool Correcto = true;
+   {
+      controlPID A, B;
+      Correcto = VerificarTiempos("controlPID", A, B) && Correcto;
+   }
+   {
+      controlPIDT<float> A(PID_SIN_SALIDA), B(PID_SIN_SALIDA);
+      Correcto = VerificarTiempos("controlPIDT<float>", A, B) && Correcto;
+   }
+   {
+      controlPIDT<fijoQ16> A(PID_SIN_SALIDA), B(PID_SIN_SALIDA);
+      Correcto = VerificarTiempos("controlPIDT<fijoQ16>", A, B) && Correcto;
+   }
+   {
+      controlPIDFijo<PID_ESTRUCTURA_PID | PID_LIMITAR | PID_ANTIENROLE> A, B;
+      Correcto = VerificarTiempos("controlPIDFijo", A, B) && Correcto;
+   }
+   {
+      controlPIDProgramado A(PID_SIN_SALIDA), B(PID_SIN_SALIDA);
+      A.Programar(Tabla, 3, PID_PROGRAMA_MEDICION);
+      B.Programar(Tabla, 3, PID_PROGRAMA_MEDICION);
+      Correcto = VerificarTiempos("controlPIDProgramado", A, B) && Correcto;
+   }
+   Correcto = VerificarReconfigurar() && Correcto;
+   Correcto = VerificarReinicio() && Correcto;
+   Correcto = VerificarPlanificador() && Correcto;
+#if PID_EVENTOS
+   Correcto = VerificarEventos(0) && Correcto;
+   Correcto = VerificarEventos(10000) && Correcto;
+#endif
+   if (Traza) {
+      Correcto = GrabarTrazaDesborde(Traza) && Correcto;
+   }
+   return Correcto ? 0 : 1;
+}
+
+/**************************************************************************************************
+* FIN DE ARCHIVO host/verificar_pid.cpp
+**************************************************************************************************/